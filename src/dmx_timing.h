@@ -0,0 +1,163 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+// ===========================================================
+// DMX TIMING ANALYZER
+// ===========================================================
+//
+// Pure logica, geen Arduino-afhankelijkheden: op de Uno gevoed door
+// Timer1 input capture (self-test), op de host door een opgenomen
+// pin-trace (tools/dmx_trace_replay.cpp).
+//
+// edge() krijgt elke flank met een 16-bit tijdstempel in ticks van 0.5 us
+// (Timer1, prescaler 8 @ 16 MHz). Alle gemeten tijden zijn < 32 ms, dus
+// wrap-around van de timer is geen probleem.
+//
+// 'bias' = tijd (ticks) die de meting zelf na deze flank van de zender
+// afsnoepte: op de Uno loopt de capture-ISR tijdens DmxSimple's break en MAB
+// (interrupts aan) en rekt die dus op. Het interval dat met deze flank begint
+// wordt ermee gecorrigeerd. Een trace van buitenaf heeft geen bias (0).
+
+#define DMXT_TICK_SHIFT    1     // ticks -> us: >> 1
+#define DMXT_BINS          8
+
+// DMX512-A zender-minima
+#define DMXT_BREAK_MIN_US  92
+#define DMXT_MAB_MIN_US    12
+#define DMXT_SLOT_MIN_US   44    // 11 bits van 4 us
+
+#define DMXT_BREAK_DETECT_US  44 // langer laag dan een 0x00 byte (36 us) = break
+#define DMXT_SLOT_DETECT_US   38 // falling edge na 9.5 bits = volgende startbit
+
+// Histogram met vaste bin-breedte (2^shift us). Bin 0 vangt ook alles
+// onder 'base', de laatste bin alles erboven.
+struct DmxTimingHist {
+  uint16_t base;
+  uint8_t  shift;
+  uint16_t minUs;
+  uint16_t maxUs;
+  uint16_t count;
+  uint16_t bin[DMXT_BINS];
+
+  void reset(uint16_t b, uint8_t s) {
+    base = b;
+    shift = s;
+    minUs = 0xFFFF;
+    maxUs = 0;
+    count = 0;
+    memset(bin, 0, sizeof(bin));
+  }
+
+  void add(uint16_t us) {
+    if (us < minUs) minUs = us;
+    if (us > maxUs) maxUs = us;
+    if (count < 0xFFFF) count++;
+
+    uint16_t i = (us > base) ? (uint16_t)((us - base) >> shift) : 0;
+    if (i >= DMXT_BINS) i = DMXT_BINS - 1;
+    if (bin[i] < 0xFFFF) bin[i]++;
+  }
+};
+
+enum DmxTimingState : uint8_t { DMXT_SYNC, DMXT_MAB, DMXT_SLOTS };
+
+struct DmxTiming {
+  DmxTimingHist brk;     // break lengte (us)
+  DmxTimingHist mab;     // mark-after-break (us)
+  DmxTimingHist slot;    // startbit -> startbit (us)
+  DmxTimingHist fps;     // frames per seconde
+
+  uint8_t  state;
+  bool     haveFall;     // lastFall geldig (niet na resync)
+  uint16_t lastFall;
+  uint16_t lastRise;
+  uint16_t slotStart;
+  uint8_t  fallBias;     // bias van lastFall / lastRise / slotStart
+  uint8_t  riseBias;
+  uint8_t  slotBias;
+  uint8_t  biasMaxUs;    // grootste gecorrigeerde bias, ter info
+  uint16_t pendingUs;    // periode van vorige slot, pas geldig bij volgende startbit
+  bool     slotPending;
+  uint16_t frames;       // breaks sinds laatste window()
+
+  void reset() {
+    brk.reset(80, 2);    //  80..112 us
+    mab.reset(0, 2);     //   0..32 us
+    slot.reset(40, 3);   //  40..104 us
+    fps.reset(0, 3);     //   0..64 fps
+    lastFall = lastRise = slotStart = 0;
+    fallBias = riseBias = slotBias = 0;
+    biasMaxUs = 0;
+    frames = 0;
+    resync();
+  }
+
+  // Flanken gemist (buffer vol, capture even uit): wacht op de volgende break
+  void resync() {
+    state = DMXT_SYNC;
+    haveFall = false;
+    slotPending = false;
+  }
+
+  // Interval van 'from' (met bias) tot 't', in us
+  static uint16_t span(uint16_t from, uint8_t bias, uint16_t t) {
+    uint16_t d = t - from;
+    d = (d > bias) ? d - bias : 0;
+    return d >> DMXT_TICK_SHIFT;
+  }
+
+  void edge(bool rising, uint16_t t, uint8_t bias = 0) {
+    if ((bias >> DMXT_TICK_SHIFT) > biasMaxUs) biasMaxUs = bias >> DMXT_TICK_SHIFT;
+
+    if (rising) {
+      if (!haveFall) return;
+      uint16_t lowUs = span(lastFall, fallBias, t);
+      lastRise = t;
+      riseBias = bias;
+      if (lowUs >= DMXT_BREAK_DETECT_US) {
+        // De falling edge van deze break was geen startbit
+        slotPending = false;
+        brk.add(lowUs);
+        frames++;
+        state = DMXT_MAB;
+      }
+      return;
+    }
+
+    if (state == DMXT_MAB) {
+      mab.add(span(lastRise, riseBias, t));
+      state = DMXT_SLOTS;
+      slotStart = t;
+      slotBias = bias;
+    }
+    else if (state == DMXT_SLOTS) {
+      uint16_t us = span(slotStart, slotBias, t);
+      if (us >= DMXT_SLOT_DETECT_US) {
+        if (slotPending) slot.add(pendingUs);
+        pendingUs = us;
+        slotPending = true;
+        slotStart = t;
+        slotBias = bias;
+      }
+      // anders: flank binnen de databits
+    }
+    lastFall = t;
+    fallBias = bias;
+    haveFall = true;
+  }
+
+  // Meetvenster afsluiten: frames -> fps over 'ms' (klok van de aanroeper)
+  void window(uint16_t ms) {
+    if (ms) fps.add((uint32_t)frames * 1000 / ms);
+    frames = 0;
+  }
+
+  bool pass() const {
+    return brk.count && mab.count && slot.count &&
+           brk.minUs  >= DMXT_BREAK_MIN_US &&
+           mab.minUs  >= DMXT_MAB_MIN_US &&
+           slot.minUs >= DMXT_SLOT_MIN_US;
+  }
+};
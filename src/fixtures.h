@@ -0,0 +1,59 @@
+#pragma once
+
+// ===========================================================
+// FIXTURE PROFIELEN (PROGMEM)
+// ===========================================================
+//
+// Elk profiel beschrijft één toesteltype: aantal kanalen, op welke
+// offset (t.o.v. het startadres) elk logisch attribuut zit, en een
+// default-waarde voor kanalen zonder attribuut (strobe, fan, ...).
+
+#define FX_NONE         0xFF   // attribuut niet aanwezig in dit profiel
+#define FIXTURE_MAX_CH  8
+
+struct FixtureProfile {
+  uint8_t channels;                  // aantal DMX-kanalen
+  uint8_t dimmer;                    // offsets, FX_NONE = niet aanwezig
+  uint8_t red;
+  uint8_t green;
+  uint8_t blue;
+  uint8_t white;
+  uint8_t defaults[FIXTURE_MAX_CH];  // waarde voor kanalen zonder attribuut
+};
+
+enum FixtureProfileId : uint8_t {
+  PROFILE_DIMMER,   // 1ch: generieke dimmer (oud gedrag: 1 kanaal = Volume)
+  PROFILE_RGB,      // 3ch: R G B
+  PROFILE_RGBW,     // 4ch: R G B W
+  PROFILE_DRGBWS,   // 6ch: Dim R G B W Strobe
+  PROFILE_FOG,      // 2ch: Output Fan
+  PROFILE_COUNT
+};
+
+constexpr FixtureProfile fixtureProfiles[PROFILE_COUNT] PROGMEM = {
+  // ch  dim      R        G        B        W        defaults
+  {  1,  0,       FX_NONE, FX_NONE, FX_NONE, FX_NONE, { 0 } },
+  {  3,  FX_NONE, 0,       1,       2,       FX_NONE, { 0 } },
+  {  4,  FX_NONE, 0,       1,       2,       3,       { 0 } },
+  {  6,  0,       1,       2,       3,       4,       { 0, 0, 0, 0, 0, 0 } },
+  {  2,  0,       FX_NONE, FX_NONE, FX_NONE, FX_NONE, { 0, 255 } },
+};
+
+// patchCompile() leest defaults[off] voor off < channels
+constexpr bool fixtureProfilesFit(uint8_t i = 0) {
+  return i >= PROFILE_COUNT ||
+         (fixtureProfiles[i].channels <= FIXTURE_MAX_CH && fixtureProfilesFit(i + 1));
+}
+static_assert(fixtureProfilesFit(), "fixtureProfiles: channels > FIXTURE_MAX_CH");
+
+enum DmxUniverseId : uint8_t {
+  UNIVERSE_A,       // DmxSimple op DMX_PIN 8
+  UNIVERSE_B,       // hardware USART (TX pin 1)
+};
+
+// Eén toestel in de patch: profiel + DMX startadres (1..512) + universe
+struct FixturePatch {
+  uint8_t  profile;
+  uint16_t address;
+  uint8_t  universe;   // UNIVERSE_A of UNIVERSE_B, altijd invullen
+};
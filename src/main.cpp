@@ -14,7 +14,12 @@
 #define OLED_CS   10
 #define OLED_DC    7
 #define OLED_RST   12
+#ifdef UI_BENCH
+#include "ui_bench.h"
+BenchSSD1351 display(128, 128, &SPI, OLED_CS, OLED_DC, OLED_RST);  // mock: telt enkel SPI-verkeer
+#else
 Adafruit_SSD1351 display(128, 128, &SPI, OLED_CS, OLED_DC, OLED_RST);
+#endif
 
 #define ENC_A   5
 #define ENC_B   4
@@ -106,6 +111,155 @@ unsigned long activeEndMs = 0;
 unsigned long lastDMX = 0;
 const uint16_t DMX_RATE = 30;
 
+// Universe B: hardware USART (TX = pin 1) naar een tweede MAX485. Het
+// frame loopt volledig in de USART ISR's (TXC, UDRE): een trage loop()
+// (scherm, knop ingedrukt houden) geeft geen pauzes midden in een frame.
+// HardwareSerial (Serial) mag daarom niet gelinkt worden: die heeft zelf
+// een UDRE ISR. Tekstuitvoer gaat via 'report' (zie USART RAPPORT).
+#define DMX_UNIVERSE_B   1        // 0 = enkel universe A
+#define DMX_RATE_B      30        // frames/s
+#define DMX_SLOTS_B    512
+#define DMX_UBRR         7        // U2X: 16 MHz / 8 / (7 + 1)  = 250 kbaud
+#define DMX_BREAK_UBRR  21        // U2X: 16 MHz / 8 / (21 + 1) = ~90.9 kbaud;
+                                  // 0x00 8N2: 99 us laag (break), 22 us hoog (MAB)
+
+enum UniverseState { UNI_IDLE, UNI_BREAK, UNI_SLOTS, UNI_DRAIN };
+volatile UniverseState uniBState = UNI_IDLE;  // enkel loop() verlaat UNI_IDLE
+bool          uniBEnabled = false;
+uint16_t      dmxRateB = DMX_RATE_B;  // 0 = zo snel mogelijk (CPU-meting)
+unsigned long uniBFrameMs = 0;
+uint16_t      uniBSlot = 0;       // volgende slot (0 = start code), ISR
+uint8_t       uniBCursor = 0;     // positie in patchOrderB, ISR
+
+uint8_t dmxCpuLoadPct = 0xFF;     // gemeten bij opstarten, 0xFF = niet gemeten
+#define DMX_LOAD_WINDOW_MS 300
+
+// ===========================================================
+// FIXTURE PATCH
+// ===========================================================
+
+#include "fixtures.h"   // profielen (kanalen, offsets, defaults) in PROGMEM
+
+// Welk toestel op welk startadres (en universe). Entry 0 volgt het
+// 'Channel' menu-item, extra toestellen hier toevoegen.
+FixturePatch patch[] = {
+  { PROFILE_DIMMER, 1, UNIVERSE_A },
+  // { PROFILE_RGBW,  10, UNIVERSE_A },
+  // { PROFILE_FOG,   20, UNIVERSE_A },
+  // { PROFILE_RGBW,   1, UNIVERSE_B },
+};
+const uint8_t PATCH_COUNT = sizeof(patch) / sizeof(patch[0]);
+
+// Logische kleur; intensiteit = felheid tijdens DMX_ACTIVE, anders 0.
+// Kleur enkel via patchSetColor() aanpassen. patchDirty is voor adreswijzigingen.
+uint8_t colorR = 255;
+uint8_t colorG = 255;
+uint8_t colorB = 255;
+uint8_t colorW = 255;
+
+// Logische bronnen. *_DIM = kleur geschaald met intensiteit
+// (voor profielen zonder eigen dimmer-kanaal).
+enum PatchSrc : uint8_t {
+  SRC_DIMMER,
+  SRC_RED, SRC_GREEN, SRC_BLUE, SRC_WHITE,
+  SRC_RED_DIM, SRC_GREEN_DIM, SRC_BLUE_DIM, SRC_WHITE_DIM,
+  SRC_COUNT
+};
+
+// Voorgecompileerde mapping: [0, patchDynLen) = slot <- bron (elk frame),
+// [patchDynLen, patchMapLen) = slot <- vaste waarde in 'src' (1x bij compileren).
+#define PATCH_MAP_MAX 32
+struct PatchSlot {
+  uint16_t slot;
+  uint8_t  src;
+  uint8_t  universe;
+};
+PatchSlot patchMap[PATCH_MAP_MAX];
+uint8_t patchDynLen = 0;
+uint8_t patchMapLen = 0;
+
+// Universe B heeft geen 512-byte buffer: elk frame wordt uit de mapping
+// gegenereerd. patchOrderB = indices in patchMap, gesorteerd op slot.
+uint8_t patchOrderB[PATCH_MAP_MAX];
+uint8_t patchOrderBLen = 0;
+uint8_t patchVal[SRC_COUNT];   // huidige waarde per logische bron
+
+bool    patchDirty = true;     // opnieuw compileren (startadres gewijzigd)
+bool    patchOverflow = false; // slots weggevallen (> 512 of mapping vol), zie titel
+int16_t lastIntensity = -1;    // laatst verstuurde intensiteit (-1 = nog niets)
+
+// ===========================================================
+// TIMER1 INPUT CAPTURE (self-test of MIDI in)
+// ===========================================================
+//
+// De capture-ISR doet enkel een tijdstempel in deze ringbuffer; de analyse
+// loopt in loop(). Self-test en MIDI sluiten elkaar uit, 'flags' is per
+// gebruiker (zie SELF-TEST en midiCaptureEdge()).
+
+#define CAPTURE_RING 32           // macht van 2
+
+struct CaptureEdge {
+  uint32_t t;
+  uint8_t  flags;
+};
+
+CaptureEdge captureRing[CAPTURE_RING];
+volatile uint8_t captureHead = 0;
+volatile uint8_t captureTail = 0;
+volatile bool    captureOverflow = false;
+
+// Vanuit de ISR
+inline void capturePush(uint32_t t, uint8_t flags) {
+  uint8_t next = (captureHead + 1) & (CAPTURE_RING - 1);
+  if (next == captureTail) {
+    captureOverflow = true;
+    return;
+  }
+  captureRing[captureHead].t = t;
+  captureRing[captureHead].flags = flags;
+  captureHead = next;
+}
+
+// Vanuit loop(): buffer leeg maken na overflow. Geeft true als er iets wegviel.
+bool captureFlushOverflow() {
+  if (!captureOverflow) return false;
+  noInterrupts();
+  captureTail = captureHead;
+  captureOverflow = false;
+  interrupts();
+  return true;
+}
+
+// ===========================================================
+// MIDI SYNC (MIDI clock / MTC via input capture)
+// ===========================================================
+//
+// MIDI in op A0, via de analoge comparator (A0 tegen de interne 1.1 V
+// bandgap) naar Timer1 input capture. De hardware legt het tijdstip van elke
+// flank vast, ook terwijl DmxSimple interrupts uit heeft (~44 us per byte).
+// Met SoftwareSerial vielen bits in zo'n venster verkeerd (0xF8 -> 0xFC).
+
+#include "midi_sync.h"
+
+#define MIDI_IN_ADC   0      // A0: ADC-mux kanaal = negatieve comparator-ingang
+#define MIDI_TX_PIN   6      // MIDI clock uit (PD6), zie MIDI_CLOCK_OUT_BPM
+#define MIDI_TX_BIT   PD6
+
+// flags in de capture-ringbuffer
+#define MIDI_EDGE_LEVEL  0x01   // lijnniveau na de flank
+#define MIDI_EDGE_LOST   0x02   // lijn was in de ISR al terug gewisseld
+#define MIDI_EDGE_NOW    0x04   // lijnniveau in de ISR
+
+// > 0: deze box stuurt zelf MIDI clock op MIDI_TX_PIN (master of testsignaal
+// voor andere boxen). Een box ontvangt zijn eigen clock niet: het zenden
+// houdt interrupts uit voor de hele byte.
+#define MIDI_CLOCK_OUT_BPM 0
+
+MidiUart midiUart;
+MidiSync midiSync;
+bool lastSyncLocked = false;
+unsigned long midiClockOutUs = 0;
+
 
 
 // ===========================================================
@@ -180,6 +334,7 @@ inline void updateChannel(int8_t step) {
   if (ch < 1)   ch = 512;
   if (ch > 512) ch = 1;
   channel = (uint16_t)ch;
+  patchDirty = true;
 }
 
 inline void updateMinutes(int8_t step) {
@@ -249,13 +404,13 @@ void redrawRow(int index) {
     case 4: display.setCursor(MARGIN_X + 2, y);display.print("State:");break;
   }
 
-  char buf[8];
+  char buf[10];
   switch(index) {
     case 0: snprintf(buf,sizeof(buf),"%u",channel); break;
     case 1: snprintf(buf,sizeof(buf),"%02u:%02u",minutes,seconds); break;
     case 2: snprintf(buf,sizeof(buf),"%u",seconds_dur); break;
     case 3: snprintf(buf,sizeof(buf),"%u",felheid); break;
-    case 4:if (dmxState == DMX_IDLE) snprintf(buf,sizeof(buf),"STOP"); else snprintf(buf,sizeof(buf),"RUN"); break;
+    case 4:snprintf(buf,sizeof(buf),"%s%s",(dmxState == DMX_IDLE) ? "STOP" : "RUN",midiSync.locked ? " EXT" : ""); break;
   }
   display.setCursor(VAL_X, y);
   display.print(buf);
@@ -371,10 +526,24 @@ void drawTimerEditBox() {
 // STATIC UI (1x tekenen)
 // ===========================================================
 
+// Rechts naast de titel: patch-fout heeft voorrang op de CPU-meting
+void drawTitleStatus() {
+  display.fillRect(78, TITLE_Y + 4, 48, 8, WHITE);
+  if (patchOverflow) {
+    drawText("PATCH!", 78, TITLE_Y + 4, 1, BLUE);
+  }
+  else if (dmxCpuLoadPct != 0xFF) {
+    char buf[10];
+    snprintf(buf, sizeof(buf), "CPU %u%%", dmxCpuLoadPct);
+    drawText(buf, 78, TITLE_Y + 4, 1, BLACK);
+  }
+}
+
 void drawStaticUI() {
   display.fillScreen(WHITE);
 
   drawText("Menu", MARGIN_X, TITLE_Y, 2, BLACK);
+  drawTitleStatus();
   // labels worden per rij in redrawRow ook gezet, maar dit helpt bij eerste frame
   drawText("Channel:",  MARGIN_X + 2, ITEM1_Y, 1, BLACK);
   drawText("Timer:",    MARGIN_X + 2, ITEM2_Y, 1, BLACK);
@@ -461,22 +630,330 @@ void render(bool full = false) {
 // DMX ENGINE
 // ===========================================================
 
-// Stuurt elk frame (30 Hz) de actuele waarde voor het gekozen kanaal
+// Zet de patch om in een platte slot-lijst. Enkel bij wijziging, niet per frame.
+void patchCompile() {
+  // Oude slots eerst uit (bv. na kanaalwissel); universe B volgt vanzelf
+  for (uint8_t i = 0; i < patchMapLen; i++) {
+    if (patchMap[i].universe == UNIVERSE_A) DmxSimple.write(patchMap[i].slot, 0);
+  }
+
+  patch[0].address = channel;
+  patchMapLen = 0;
+  bool overflow = false;
+
+  // pass 0: dynamische slots, pass 1: vaste waarden (komen achteraan)
+  for (uint8_t pass = 0; pass < 2; pass++) {
+    if (pass == 1) patchDynLen = patchMapLen;
+
+    for (uint8_t f = 0; f < PATCH_COUNT; f++) {
+      FixtureProfile p;
+      memcpy_P(&p, &fixtureProfiles[patch[f].profile], sizeof(p));
+      bool hasDimmer = (p.dimmer != FX_NONE);
+
+      for (uint8_t off = 0; off < p.channels; off++) {
+        uint16_t slot = patch[f].address + off;
+        if (slot > 512 || patchMapLen >= PATCH_MAP_MAX) {
+          overflow = true;  // niet stil laten vallen: "PATCH!" in de titel
+          break;
+        }
+
+        uint8_t src;
+        if      (off == p.dimmer) src = SRC_DIMMER;
+        else if (off == p.red)    src = hasDimmer ? SRC_RED   : SRC_RED_DIM;
+        else if (off == p.green)  src = hasDimmer ? SRC_GREEN : SRC_GREEN_DIM;
+        else if (off == p.blue)   src = hasDimmer ? SRC_BLUE  : SRC_BLUE_DIM;
+        else if (off == p.white)  src = hasDimmer ? SRC_WHITE : SRC_WHITE_DIM;
+        else                      src = SRC_COUNT;  // geen attribuut -> default
+
+        uint8_t uni = patch[f].universe;
+        if (pass == 0 && src != SRC_COUNT) {
+          patchMap[patchMapLen++] = { slot, src, uni };
+        }
+        else if (pass == 1 && src == SRC_COUNT) {
+          patchMap[patchMapLen++] = { slot, p.defaults[off], uni };
+          if (uni == UNIVERSE_A) DmxSimple.write(slot, p.defaults[off]);
+        }
+      }
+    }
+  }
+
+  // Universe B: insertion sort op slot (max PATCH_MAP_MAX entries)
+  patchOrderBLen = 0;
+  for (uint8_t i = 0; i < patchMapLen; i++) {
+    if (patchMap[i].universe != UNIVERSE_B) continue;
+    uint8_t j = patchOrderBLen++;
+    while (j > 0 && patchMap[patchOrderB[j - 1]].slot > patchMap[i].slot) {
+      patchOrderB[j] = patchOrderB[j - 1];
+      j--;
+    }
+    patchOrderB[j] = i;
+  }
+
+  patchDirty = false;
+  lastIntensity = -1;  // volgende patchOutput() schrijft alle slots
+
+  if (overflow != patchOverflow) {
+    patchOverflow = overflow;
+    drawTitleStatus();
+  }
+}
+
+// Logische intensiteit/kleur -> alle gepatchte slots. Enkel bij wijziging:
+// een ongewijzigd frame kost één vergelijking, ongeacht het aantal toestellen.
+void patchOutput() {
+  // Tijdens een universe B frame leest de ISR patchOrderB: dan compileert
+  // dmxUniverseBService() bij de start van het volgende frame.
+  if (patchDirty && (!uniBEnabled || uniBState == UNI_IDLE)) patchCompile();
+
+  uint8_t intensity = (dmxState == DMX_ACTIVE) ? felheid : 0;
+  if (intensity == lastIntensity) return;
+  lastIntensity = intensity;
+
+  patchVal[SRC_DIMMER]    = intensity;
+  patchVal[SRC_RED]       = colorR;
+  patchVal[SRC_GREEN]     = colorG;
+  patchVal[SRC_BLUE]      = colorB;
+  patchVal[SRC_WHITE]     = colorW;
+  patchVal[SRC_RED_DIM]   = ((uint16_t)colorR * intensity) / 255;
+  patchVal[SRC_GREEN_DIM] = ((uint16_t)colorG * intensity) / 255;
+  patchVal[SRC_BLUE_DIM]  = ((uint16_t)colorB * intensity) / 255;
+  patchVal[SRC_WHITE_DIM] = ((uint16_t)colorW * intensity) / 255;
+
+  for (uint8_t i = 0; i < patchDynLen; i++) {
+    if (patchMap[i].universe == UNIVERSE_A) {
+      DmxSimple.write(patchMap[i].slot, patchVal[patchMap[i].src]);
+    }
+  }
+}
+
+// Nieuwe logische kleur: de volgende patchOutput() schrijft alle slots
+// opnieuw, ook als de intensiteit gelijk bleef (slots blijven dezelfde).
+void patchSetColor(uint8_t r, uint8_t g, uint8_t b, uint8_t w) {
+  colorR = r;
+  colorG = g;
+  colorB = b;
+  colorW = w;
+  lastIntensity = -1;
+}
+
+// Waarde van 'slot' in universe B; slots moeten oplopend gevraagd worden
+uint8_t dmxUniverseBValue(uint16_t slot) {
+  uint8_t v = 0;
+  while (uniBCursor < patchOrderBLen) {
+    uint8_t i = patchOrderB[uniBCursor];
+    if (patchMap[i].slot > slot) break;
+    if (patchMap[i].slot == slot) v = (i < patchDynLen) ? patchVal[patchMap[i].src] : patchMap[i].src;
+    uniBCursor++;
+  }
+  return v;
+}
+
+// Universe B: loop() start een frame (break = 0x00 op ~90 kbaud), de ISR's
+// doen de rest. TXC na de break: 250 kbaud, UDRE vult slot per slot bij.
+// Na de laatste slot: TXC -> UNI_IDLE. Geeft true als er een frame startte.
+bool dmxUniverseBService() {
+  if (!uniBEnabled || uniBState != UNI_IDLE) return false;
+  if (dmxRateB && millis() - uniBFrameMs < 1000UL / dmxRateB) return false;
+  uniBFrameMs = millis();
+
+  if (patchDirty) patchCompile();   // tussen twee frames: ISR leest niets
+
+  noInterrupts();
+  uniBSlot = 0;
+  uniBCursor = 0;
+  uniBState = UNI_BREAK;
+  UCSR0B = 0;
+  UBRR0  = DMX_BREAK_UBRR;
+  UCSR0A = _BV(TXC0) | _BV(U2X0);                 // TXC0 wissen
+  UCSR0C = _BV(USBS0) | _BV(UCSZ01) | _BV(UCSZ00); // 8N2
+  UCSR0B = _BV(TXEN0) | _BV(TXCIE0);               // enkel zenden, pin 0 blijft vrij
+  UDR0 = 0;                                        // break + MAB
+  interrupts();
+  return true;
+}
+
+ISR(USART_TX_vect) {
+  if (uniBState == UNI_BREAK) {
+    UBRR0 = DMX_UBRR;                  // zender is leeg: veilig omschakelen
+    uniBState = UNI_SLOTS;
+    UCSR0B = _BV(TXEN0) | _BV(UDRIE0);
+  } else {
+    UCSR0B = _BV(TXEN0);
+    uniBState = UNI_IDLE;
+  }
+}
+
+ISR(USART_UDRE_vect) {
+  UDR0 = dmxUniverseBValue(uniBSlot);
+  if (++uniBSlot > DMX_SLOTS_B) {
+    // Laatste slot in UDR0: wachten tot hij volledig buiten is
+    uniBState = UNI_DRAIN;
+    UCSR0A = _BV(TXC0) | _BV(U2X0);
+    UCSR0B = _BV(TXEN0) | _BV(TXCIE0);
+  }
+}
+
+// Buffer-update voor beide universes, elk aan eigen rate. Dit bepaalt niet
+// de refresh op de lijn. A: DmxSimple zendt continu vanuit zijn Timer2 ISR,
+// ~11 slots per ~2 ms, dus ~10 frames/s bij maxChannel(512); DMX_RATE is
+// enkel hoe vaak patchOutput() zijn buffer bijwerkt. B: DMX_RATE_B is wel
+// de frame rate op de lijn (frame-start hier, slots uit de ISR).
 void dmxWriteFrame() {
   unsigned long now = millis();
   if (now - lastDMX >= (1000UL / DMX_RATE)) {
     lastDMX = now;
+    patchOutput();   // ACTIVE -> felheid, anders uit
+  }
+  dmxUniverseBService();
+}
 
-    if (dmxState == DMX_ACTIVE) {
-      DmxSimple.write(channel, felheid); // stuur volle waarde
-    } else {
-      DmxSimple.write(channel, 0);   // anders uit
-    }
+// Lege lus-iteraties tellen gedurende DMX_LOAD_WINDOW_MS. Tijd in de ISR's
+// (DmxSimple, universe B) ontbreekt dan als lus-iteraties.
+uint32_t dmxIdleCount() {
+  uint32_t idle = 0;
+  unsigned long start = millis();
+  while (millis() - start < DMX_LOAD_WINDOW_MS) {
+    if (dmxUniverseBService()) continue;
+    idle++;
+  }
+  return idle;
+}
+
+// CPU-last bij volle 2x512 refresh: A zendt altijd 512 slots, B hier zonder
+// rate-limiet. idleRef = dmxIdleCount() vóór de DMX-uitgangen startten.
+// Bovengrens: ook de overhead van de meting zelf telt als last.
+uint8_t dmxMeasureLoad(uint32_t idleRef) {
+  uint16_t rate = dmxRateB;
+  dmxRateB = 0;
+  uint32_t idle = dmxIdleCount();
+  dmxRateB = rate;
+
+  if (idleRef == 0 || idle >= idleRef) return 0;
+  return 100 - (uint8_t)(idle * 100UL / idleRef);
+}
+
+// A0 -> comparator -> Timer1 input capture. Zelfde timer als de self-test,
+// die twee sluiten elkaar uit.
+void midiInBegin() {
+  midiUart.reset();
+  pinMode(A0, INPUT_PULLUP);     // niets aangesloten = idle (mark)
+  ADCSRA &= ~_BV(ADEN);          // ADC uit: mux vrij voor de comparator
+  ADCSRB |= _BV(ACME);
+  ADMUX   = (ADMUX & 0xF0) | MIDI_IN_ADC;
+  ACSR    = _BV(ACBG) | _BV(ACIC);  // + = bandgap 1.1 V, uitgang -> ICP1
+
+  noInterrupts();
+  TCCR1A = 0;                    // normal mode (Arduino core zet 8-bit PWM)
+  TCCR1B = _BV(ICNC1) | _BV(ICES1) | _BV(CS11);  // 0.5 us, eerst: lijn dalend
+  captureTail = captureHead;
+  captureOverflow = false;
+  TIFR1  = _BV(ICF1);
+  TIMSK1 = _BV(ICIE1);
+  interrupts();
+}
+
+// Capture-ISR (MIDI). De comparator inverteert: ACO = 1 als de lijn laag is,
+// ICES1 (stijgend) vangt dus een dalende lijn. Tijdstempel = micros() terug-
+// gerekend naar ICR1, dus onafhankelijk van de ISR-latency.
+inline void midiCaptureEdge() {
+  uint16_t t  = ICR1;
+  uint32_t us = micros() - ((uint16_t)(TCNT1 - t) >> 1);
+  bool level  = !(TCCR1B & _BV(ICES1));
+  bool now;
+
+  // Volgende flank: weg van het huidige niveau. Wisselt de lijn terwijl ICES1
+  // omgezet wordt, dan opnieuw: anders zou die flank ongemerkt wegvallen.
+  do {
+    now = !(ACSR & _BV(ACO));
+    if (now) TCCR1B |= _BV(ICES1);
+    else     TCCR1B &= ~_BV(ICES1);
+    TIFR1 = _BV(ICF1);
+  } while (now != !(ACSR & _BV(ACO)));
+
+  capturePush(us, (level ? MIDI_EDGE_LEVEL : 0) |
+                  (level != now ? MIDI_EDGE_LOST : 0) |
+                  (now ? MIDI_EDGE_NOW : 0));
+}
+
+// Flanken -> bytes (tijdstempel = startbit) -> parser
+void midiSyncPoll() {
+  if (captureFlushOverflow()) {
+    midiUart.resync(!(ACSR & _BV(ACO)), micros());
+  }
+
+  while (captureTail != captureHead) {
+    CaptureEdge e = captureRing[captureTail];
+    captureTail = (captureTail + 1) & (CAPTURE_RING - 1);
+    int16_t b = midiUart.edge(e.flags & MIDI_EDGE_LEVEL, e.t,
+                              e.flags & MIDI_EDGE_LOST, e.flags & MIDI_EDGE_NOW);
+    if (b >= 0) midiSync.feed(b, midiUart.byteUs);
+  }
+
+  // Na het leegmaken: 'now' ligt na elke verwerkte flank
+  uint32_t now = micros();
+  int16_t b = midiUart.poll(now);
+  if (b >= 0) midiSync.feed(b, midiUart.byteUs);
+  midiSync.poll(now);
+
+  if (midiSync.locked != lastSyncLocked) {
+    lastSyncLocked = midiSync.locked;
+    redrawRow(4);
+  }
+}
+
+// MIDI-byte bit-bangen op MIDI_TX_PIN. Enkel testsignaal: interrupts staan
+// uit voor de hele byte (320 us), net als bij SoftwareSerial. Universe B
+// pauzeert dan even tussen twee slots (mag in DMX).
+void midiSendByte(uint8_t b) {
+  uint16_t frame = ((uint16_t)b << 1) | 0x200;  // startbit 0, 8 databits, stopbit 1
+  noInterrupts();
+  for (uint8_t i = 0; i < 10; i++) {
+    if (frame & 1) PORTD |= _BV(MIDI_TX_BIT);
+    else           PORTD &= ~_BV(MIDI_TX_BIT);
+    frame >>= 1;
+    delayMicroseconds(MIDI_BIT_US - 1);         // ~1 us lus-overhead
+  }
+  interrupts();
+}
+
+// Lokale MIDI clock generator (enkel als MIDI_CLOCK_OUT_BPM > 0)
+void midiClockOut() {
+#if MIDI_CLOCK_OUT_BPM > 0
+  const unsigned long tickUs = 2500000UL / MIDI_CLOCK_OUT_BPM;
+  unsigned long now = micros();
+  if (now - midiClockOutUs >= tickUs) {
+    midiClockOutUs += tickUs;
+    midiSendByte(0xF8);
+  }
+#endif
+}
+
+// Externe sync: WAIT/ACTIVE volgt de fase van de show-tijd van de master,
+// zodat boxen aan dezelfde master in fase blijven, ongeacht wanneer op RUN
+// gedrukt werd. De eindtijden blijven bijgewerkt voor freewheel op millis().
+void dmxSyncController() {
+  unsigned long delayMs = (unsigned long)minutes * 60000UL + (unsigned long)seconds * 1000UL;
+  unsigned long cycleMs = delayMs + (unsigned long)seconds_dur * 1000UL;
+  if (cycleMs == 0) return;
+
+  unsigned long p   = midiSync.showMs(micros()) % cycleMs;
+  unsigned long now = millis();
+  if (p < delayMs) {
+    dmxState  = DMX_WAIT;
+    waitEndMs = now + (delayMs - p);
+  } else {
+    dmxState    = DMX_ACTIVE;
+    activeEndMs = now + (cycleMs - p);
   }
 }
 
 // State-machine: wachten -> actief -> idle
 void dmxController() {
+    if (dmxState != DMX_IDLE && midiSync.active()) {
+      dmxSyncController();
+      return;
+    }
+
     unsigned long now = millis();
 
     switch (dmxState) {
@@ -527,7 +1004,482 @@ void startDmxSequence() {
 // Optioneel: handmatig stoppen
 void stopDmxSequence() {
   dmxState = DMX_IDLE;
-  DmxSimple.write(channel, 0);
+  patchOutput();
+}
+
+
+
+// ===========================================================
+// INPUT HANDLERS
+// ===========================================================
+
+// Eén encoder-detent (step = +1 / -1)
+void handleStep(int8_t step) {
+  lastActivityMs = millis();
+
+  if (displaySleeping) {
+      display.enableDisplay(true);
+      displaySleeping = false;
+  }
+  if (mode == MODE_SELECT) {
+    // Navigeren door items
+    int8_t old = selectedIndex;
+    selectedIndex += (step > 0 ? 1 : -1);
+
+    if (selectedIndex < 0) selectedIndex = 0;
+    if (selectedIndex > 4) selectedIndex = 4;
+    
+
+    if (old != selectedIndex) {
+      redrawRow(old);
+      redrawRow(selectedIndex);
+    }
+  }
+  else { // MODE_EDIT
+    if (selectedIndex == 0) {
+      updateChannel(step);
+      redrawChannelValue();
+    }
+    else if (selectedIndex == 1) {
+      if (timerEditField == 0) {
+        updateMinutes(step);
+        redrawTimerMinutes();
+      } else {
+        bool mmChanged = updateSeconds(step);
+        redrawTimerSeconds();
+        if (mmChanged) redrawTimerMinutes();
+      }
+    }
+    else if (selectedIndex == 2) {
+      updateDuration(step);
+      redrawDurationValue();
+    }
+    else if (selectedIndex == 3) {
+      updateFelheid(step);
+      redrawFelheidValue();
+    }
+  }
+}
+
+// Eén knopdruk
+void handleClick() {
+  lastActivityMs = millis();
+
+  if (displaySleeping) {
+      display.enableDisplay(true);
+      displaySleeping = false;
+  }
+
+  if (mode == MODE_SELECT) {
+
+      if (selectedIndex == 4) {
+          // START / STOP knop
+          if (dmxState == DMX_IDLE) {
+              startDmxSequence();
+          } else {
+              stopDmxSequence();
+          }
+          redrawRow(4);
+      } 
+      else {
+          mode = MODE_EDIT;
+          timerEditField = 0;
+          redrawRow(selectedIndex);
+      }
+  }
+
+  else { // MODE_EDIT
+      if (selectedIndex == 1) {
+          if (timerEditField == 0) {
+              clearTimerEditBoxes();
+              timerEditField = 1;
+              drawTimerEditBox();
+          } else {
+              mode = MODE_SELECT;
+              redrawRow(selectedIndex);
+          }
+      } else {
+          mode = MODE_SELECT;
+          redrawRow(selectedIndex);
+      }
+  }
+}
+
+
+
+// ===========================================================
+// USART RAPPORT (self-test, UI bench)
+// ===========================================================
+//
+// Tekst naar pin 1 zonder HardwareSerial (zie universe B), gepolled.
+// Enkel waar universe B uit staat: self-test en UI bench.
+
+class UsartPrint : public Print {
+public:
+  void begin(uint32_t baud) {
+    UCSR0B = 0;
+    UBRR0  = F_CPU / 8 / baud - 1;                // U2X, zoals HardwareSerial
+    UCSR0A |= _BV(U2X0);
+    UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);           // 8N1
+    UCSR0B = _BV(TXEN0);
+  }
+
+  size_t write(uint8_t c) override {
+    while (!(UCSR0A & _BV(UDRE0))) {}
+    UDR0 = c;
+    return 1;
+  }
+  using Print::write;
+};
+
+UsartPrint report;
+
+
+
+// ===========================================================
+// UI BENCH (env:uno_uibench, -DUI_BENCH)
+// ===========================================================
+//
+// Gescripte interacties tegen de mock display; per scenario SPI-bytes,
+// adresvensters, pixels, transacties en tekens via 'report', vergeleken met
+// het budget in ui_bench_budget.h. Eén teller boven budget = REGRESSIE/FAIL.
+// Zelfde code draait op de host: make -C tools check (exit code 1 bij FAIL).
+
+#ifdef UI_BENCH
+
+#include "ui_bench_budget.h"
+
+// Vaste beginstand per scenario: rij 'row' geselecteerd, default waarden
+void benchReset(int8_t row) {
+  mode = MODE_SELECT;
+  selectedIndex = row;
+  timerEditField = 0;
+  channel = 1;
+  minutes = 10;
+  seconds = 0;
+  seconds_dur = 0;
+  felheid = 0;
+  dmxState = DMX_IDLE;
+  render(true);
+  display.resetStats();
+}
+
+void benchSpin(int8_t row) {
+  benchReset(row);
+  handleClick();
+  for (uint8_t i = 0; i < 100; i++) handleStep(1);
+  handleClick();
+}
+
+void benchBoot()        { benchReset(0); render(true); }
+void benchSelectRows()  {
+  benchReset(0);
+  for (uint8_t i = 0; i < 4; i++) handleStep(1);
+  for (uint8_t i = 0; i < 4; i++) handleStep(-1);
+}
+void benchSpinChannel() { benchSpin(0); }
+void benchSpinMM()      { benchSpin(1); handleClick(); }   // MM, daarna SS zonder draaien
+void benchSpinSS()      {
+  benchReset(1);
+  handleClick();
+  handleClick();                                          // MM -> SS
+  for (uint8_t i = 0; i < 100; i++) handleStep(1);
+  handleClick();
+}
+void benchSpinDuration() { benchSpin(2); }
+void benchSpinVolume()   { benchSpin(3); }
+void benchTimerCycle()   {
+  benchReset(1);
+  handleClick(); handleStep(1);                          // MM +1
+  handleClick(); handleStep(1);                          // SS +1
+  handleClick();
+}
+
+struct BenchScenario {
+  const char* name;
+  void (*run)();
+};
+
+const BenchScenario benchScenarios[] = {
+  { "boot",        benchBoot },
+  { "select-rows", benchSelectRows },
+  { "spin-chan",   benchSpinChannel },
+  { "spin-mm",     benchSpinMM },
+  { "spin-ss",     benchSpinSS },
+  { "spin-dur",    benchSpinDuration },
+  { "spin-vol",    benchSpinVolume },
+  { "timer-cycle", benchTimerCycle },
+};
+const uint8_t BENCH_COUNT = sizeof(benchScenarios) / sizeof(benchScenarios[0]);
+
+static_assert(sizeof(benchBudget) / sizeof(benchBudget[0]) == BENCH_COUNT,
+              "ui_bench_budget.h: één rij per scenario");
+
+void benchPrintCol(uint32_t v, uint8_t width) {
+  char buf[12];
+  uint8_t n = snprintf(buf, sizeof(buf), "%lu", (unsigned long)v);
+  while (n++ < width) report.print(' ');
+  report.print(buf);
+}
+
+// Geeft true als elk scenario binnen zijn budget blijft
+bool uiBenchRun() {
+  report.begin(115200);
+  report.println(F("scenario       spi-bytes  windows   pixels  trans glyphs  budget-bytes  result"));
+  bool allOk = true;
+
+  for (uint8_t i = 0; i < BENCH_COUNT; i++) {
+    benchScenarios[i].run();
+    const BenchStats& st = display.stats;
+    BenchStats b;
+    memcpy_P(&b, &benchBudget[i], sizeof(b));
+
+    char name[16];
+    snprintf(name, sizeof(name), "%-13s", benchScenarios[i].name);
+    report.print(name);
+    benchPrintCol(st.spiBytes, 11);
+    benchPrintCol(st.windows, 9);
+    benchPrintCol(st.pixels, 9);
+    benchPrintCol(st.transactions, 7);
+    benchPrintCol(st.glyphs, 7);
+    benchPrintCol(b.spiBytes, 14);
+
+    bool ok = st.spiBytes <= b.spiBytes && st.windows <= b.windows &&
+              st.pixels <= b.pixels && st.transactions <= b.transactions &&
+              st.glyphs <= b.glyphs;
+    allOk &= ok;
+    report.println(ok ? F("  ok") : F("  REGRESSIE"));
+  }
+
+  report.println(allOk ? F("PASS") : F("FAIL"));
+  return allOk;
+}
+
+#endif
+
+
+
+// ===========================================================
+// SELF-TEST: DMX TIMING (loopback via input capture)
+// ===========================================================
+//
+// Knop ingedrukt bij opstarten -> self-test i.p.v. menu. DMX_PIN 8 is ook
+// ICP1 (Timer1 input capture): de eigen uitgang wordt teruggelezen zonder
+// extra bedrading. Alle slots blijven 0 (blackout), zodat elke byte exact
+// één falling edge heeft: de startbit.
+//
+// DmxSimple verstuurt elke byte met interrupts uit; de capture-ISR loopt
+// dus ná de byte, met ICR1 = tijdstip van de startbit. Tijdens break en MAB
+// staan interrupts wel aan: daar wisselen we van flank, en daar rekt de ISR
+// DmxSimple's delayMicroseconds() op. De break (~88-90 us) zou zo langer
+// lijken dan zonder self-test. Daarom doet de ISR enkel een tijdstempel in
+// een ringbuffer, met zijn eigen duur als bias; dmx_timing.h trekt die af.
+// De analyse zelf loopt in loop().
+//
+// Bias = span in de ISR (TCNT1 bij begin tot na het schrijven in de ring)
+// + selftestIsrTicks: de rest (vector, proloog, head-update, epiloog, reti).
+// Die rest wordt bij het opstarten gemeten op de echte ISR, zie
+// selftestCalibrate(); geen schatting uit de broncode.
+
+#include "dmx_timing.h"
+
+static_assert(DMX_PIN == 8, "Self-test leest ICP1 (PB0 = pin 8)");
+
+#define CAPTURE_RISING     0x80   // flags: bit 7 = rising, bits 0-6 = span in de ISR (ticks)
+#define CAPTURE_ISR_FALLBACK 16   // ticks (8 us = 128 cycles) als de kalibratie niets zag
+
+bool selftestMode = false;
+DmxTiming dmxTiming;
+unsigned long selftestWindowMs = 0;
+uint16_t selftestLost = 0;        // keren dat de ringbuffer vol zat
+uint8_t  selftestIsrTicks = CAPTURE_ISR_FALLBACK;  // ISR-duur buiten de span
+bool     selftestCalibrated = false;
+
+// Capture-ISR (self-test): flank + span naar de ringbuffer. De tweede
+// TCNT1-lezing komt na het schrijven van het tijdstempel; de span zelf gaat
+// als laatste in de slot, daarna enkel nog de head-update.
+inline void selftestCaptureEdge() {
+  uint16_t entry = TCNT1;
+  uint16_t t = ICR1;
+  uint8_t flags = 0;
+
+  if (TCCR1B & _BV(ICES1)) {
+    flags = CAPTURE_RISING;
+    TCCR1B &= ~_BV(ICES1);
+    TIFR1 = _BV(ICF1);          // flankwissel kan ICF1 zetten
+  }
+  else if (!(PINB & _BV(PB0))) {
+    // Lijn nog laag na de flank: dit is de break, wacht op het einde
+    TCCR1B |= _BV(ICES1);
+    TIFR1 = _BV(ICF1);
+  }
+
+  uint8_t head = captureHead;
+  uint8_t next = (head + 1) & (CAPTURE_RING - 1);
+  if (next == captureTail) {
+    captureOverflow = true;
+    return;
+  }
+  captureRing[head].t = t;
+  uint16_t span = (uint16_t)(TCNT1 - entry);
+  captureRing[head].flags = flags | (span > 0x7F ? 0x7F : span);
+  captureHead = next;
+}
+
+ISR(TIMER1_CAPT_vect) {
+  if (selftestMode) selftestCaptureEdge();
+  else              midiCaptureEdge();
+}
+
+// Capture aan/uit. Aanzetten begint altijd op een falling edge, met een
+// lege buffer en een analyzer die op de volgende break wacht.
+void selftestCapture(bool on) {
+  noInterrupts();
+  if (on) {
+    captureTail = captureHead;
+    captureOverflow = false;
+    TCCR1B &= ~_BV(ICES1);
+    TIFR1  = _BV(ICF1);
+    TIMSK1 = _BV(ICIE1);
+  } else {
+    TIMSK1 = 0;
+  }
+  interrupts();
+  if (on) dmxTiming.resync();
+}
+
+// Ringbuffer leegmaken in de analyzer (vanuit loop)
+void selftestDrain() {
+  if (captureFlushOverflow()) {
+    selftestLost++;
+    dmxTiming.resync();
+    return;
+  }
+  while (captureTail != captureHead) {
+    CaptureEdge e = captureRing[captureTail];
+    captureTail = (captureTail + 1) & (CAPTURE_RING - 1);
+    uint16_t bias = (e.flags & 0x7F) + selftestIsrTicks;
+    dmxTiming.edge(e.flags & CAPTURE_RISING, (uint16_t)e.t, bias > 0xFF ? 0xFF : bias);
+  }
+}
+
+// ISR-duur buiten de span meten, vóór DmxSimple de pin overneemt: zelf een
+// flank maken op pin 8 (ook ICP1) en TCNT1 lezen ervoor en na de ISR.
+// Totaal - span = vector, proloog, head-update, epiloog en reti, plus de
+// meetlus zelf en 1 tick afronding: dus een bovengrens. Beide paden: dalend
+// met lijn laag (break, het langste) en stijgend.
+void selftestCalibrate() {
+  pinMode(DMX_PIN, OUTPUT);
+  digitalWrite(DMX_PIN, HIGH);
+  selftestCapture(true);
+
+  uint8_t rest = 0;
+  bool seen = false;
+  for (uint8_t i = 0; i < 2; i++) {
+    uint8_t head = captureHead;
+    uint16_t t0 = TCNT1;
+    if (i == 0) PORTB &= ~_BV(PB0);
+    else        PORTB |= _BV(PB0);
+    for (uint8_t n = 0; n < 255 && captureHead == head; n++) {}
+    uint16_t total = (uint16_t)(TCNT1 - t0) + 1;
+    if (captureHead == head) continue;    // geen capture: fallback houden
+
+    uint8_t span = captureRing[head].flags & 0x7F;
+    if (total > span && total - span > rest) rest = total - span;
+    seen = true;
+  }
+
+  selftestCapture(false);
+  if (seen) selftestIsrTicks = rest;
+  selftestCalibrated = seen;
+}
+
+void selftestBegin() {
+  dmxTiming.reset();
+
+  noInterrupts();
+  TCCR1A = 0;
+  TCCR1B = _BV(ICNC1) | _BV(CS11);  // falling edge, prescaler 8 -> 0.5 us
+  interrupts();
+  selftestCalibrate();
+  selftestCapture(true);
+
+  selftestWindowMs = millis();
+  report.begin(115200);
+  report.print(F("ISR kalibratie "));
+  report.print(selftestIsrTicks);
+  report.println(selftestCalibrated ? F(" ticks") : F(" ticks (fallback, geen capture)"));
+  display.fillScreen(WHITE);
+  drawText("DMX self-test", MARGIN_X, 2, 1, BLACK);
+}
+
+void selftestPrintHist(const char* name, const DmxTimingHist& h) {
+  report.print(name);
+  report.print(' ');
+  report.print(h.minUs);
+  report.print('-');
+  report.print(h.maxUs);
+  report.print(" [");
+  for (uint8_t i = 0; i < DMXT_BINS; i++) {
+    if (i) report.print(' ');
+    report.print(h.bin[i]);
+  }
+  report.println(']');
+}
+
+// Label + min-max, met daaronder 8 balkjes (schaal = grootste bin)
+void selftestDrawHist(int16_t y, const char* name, const DmxTimingHist& h) {
+  display.fillRect(0, y, 128, 28, WHITE);
+
+  char buf[22];
+  if (h.count) snprintf(buf, sizeof(buf), "%s %u-%u", name, h.minUs, h.maxUs);
+  else         snprintf(buf, sizeof(buf), "%s --", name);
+  drawText(buf, MARGIN_X, y, 1, BLACK);
+
+  uint16_t top = 1;
+  for (uint8_t i = 0; i < DMXT_BINS; i++) {
+    if (h.bin[i] > top) top = h.bin[i];
+  }
+  for (uint8_t i = 0; i < DMXT_BINS; i++) {
+    int16_t bh = (uint32_t)h.bin[i] * 16 / top;
+    if (h.bin[i] && bh == 0) bh = 1;
+    display.fillRect(MARGIN_X + i * 14, y + 26 - bh, 12, bh, BLUE);
+  }
+}
+
+// Elke seconde: capture uit, fps afsluiten, rapporteren, capture weer aan.
+// Scherm en rapport tijdens de meting zouden de ringbuffer laten overlopen.
+void selftestLoop() {
+  selftestDrain();
+
+  unsigned long now = millis();
+  if (now - selftestWindowMs < 1000UL) return;
+
+  selftestCapture(false);
+  selftestDrain();
+  dmxTiming.window(now - selftestWindowMs);
+  bool ok = dmxTiming.pass();
+
+  selftestPrintHist("BRK us", dmxTiming.brk);
+  selftestPrintHist("MAB us", dmxTiming.mab);
+  selftestPrintHist("SLOT us", dmxTiming.slot);
+  selftestPrintHist("FPS", dmxTiming.fps);
+  report.print("ISR bias max ");
+  report.print(dmxTiming.biasMaxUs);
+  report.print(" us (afgetrokken), resync ");
+  report.println(selftestLost);
+  report.println(ok ? "PASS" : "FAIL");
+
+  display.fillRect(96, 2, 32, 8, WHITE);
+  drawText(ok ? "PASS" : "FAIL", 100, 2, 1, BLACK);
+  selftestDrawHist(14, "BRK",  dmxTiming.brk);
+  selftestDrawHist(42, "MAB",  dmxTiming.mab);
+  selftestDrawHist(70, "SLOT", dmxTiming.slot);
+  selftestDrawHist(98, "FPS",  dmxTiming.fps);
+
+  // Venster start pas na het rapport, zodat fps enkel meettijd telt
+  selftestWindowMs = millis();
+  selftestCapture(true);
 }
 
 
@@ -548,7 +1500,17 @@ void setup() {
   display.begin();
   display.setRotation(0);
   display.setTextWrap(false);
-  render(true);
+
+#ifdef UI_BENCH
+  uiBenchRun();
+  return;
+#endif
+
+  selftestMode = (digitalRead(ENC_SW) == LOW);  // knop bij opstarten = self-test
+  if (selftestMode) selftestBegin();
+
+  // Referentie voor de CPU-meting: lege lus, nog geen DMX
+  uint32_t idleRef = selftestMode ? 0 : dmxIdleCount();
 
   // ===========================
   // DMX Upload‑Safe Mode -> want use serial pins
@@ -556,6 +1518,26 @@ void setup() {
 
   DmxSimple.usePin(DMX_PIN);  // hier stel je de DMX-uitgang in
   DmxSimple.maxChannel(512);  // maximaal aantal DMX-kanalen
+
+  // Universe B op de USART (niet in self-test: die rapporteert erover)
+  if (!selftestMode) {
+    patchOutput();              // patch klaarzetten, DmxSimple loopt
+    uniBEnabled = DMX_UNIVERSE_B;
+    dmxCpuLoadPct = dmxMeasureLoad(idleRef);
+    render(true);
+  }
+
+  // MIDI sync (niet in self-test: die gebruikt Timer1 capture zelf)
+  if (!selftestMode) {
+    midiSync.reset();
+    midiInBegin();
+#if MIDI_CLOCK_OUT_BPM > 0
+    pinMode(MIDI_TX_PIN, OUTPUT);
+    digitalWrite(MIDI_TX_PIN, HIGH);
+    midiSendByte(0xFA);         // Start
+    midiClockOutUs = micros();
+#endif
+  }
 }
 
 
@@ -652,106 +1634,31 @@ void setup() {
 
 void loop() {
 
-  // --- Encoder draaien ---
-  int8_t step = readEncoderStep();
-
-  if (step != 0) {
-    lastActivityMs = millis();
+#ifdef UI_BENCH
+  return;             // bench draait 1x vanuit setup()
+#endif
 
-    if (displaySleeping) {
-        display.enableDisplay(true);
-        displaySleeping = false;
-    }
-    if (mode == MODE_SELECT) {
-      // Navigeren door items
-      int8_t old = selectedIndex;
-      selectedIndex += (step > 0 ? 1 : -1);
-
-      if (selectedIndex < 0) selectedIndex = 0;
-      if (selectedIndex > 4) selectedIndex = 4;
-      
-
-      if (old != selectedIndex) {
-        redrawRow(old);
-        redrawRow(selectedIndex);
-      }
-    }
-    else { // MODE_EDIT
-      if (selectedIndex == 0) {
-        updateChannel(step);
-        redrawChannelValue();
-      }
-      else if (selectedIndex == 1) {
-        if (timerEditField == 0) {
-          updateMinutes(step);
-          redrawTimerMinutes();
-        } else {
-          bool mmChanged = updateSeconds(step);
-          redrawTimerSeconds();
-          if (mmChanged) redrawTimerMinutes();
-        }
-      }
-      else if (selectedIndex == 2) {
-        updateDuration(step);
-        redrawDurationValue();
-      }
-      else if (selectedIndex == 3) {
-        updateFelheid(step);
-        redrawFelheidValue();
-      }
-    }
+  if (selftestMode) {
+    selftestLoop();   // geen menu, DMX blijft op blackout
+    return;
   }
 
-  // --- Knop gedrukt ---
-  if (buttonClicked()) {
-
-    lastActivityMs = millis();
-
-    if (displaySleeping) {
-        display.enableDisplay(true);
-        displaySleeping = false;
-    }
-
-    if (mode == MODE_SELECT) {
-
-        if (selectedIndex == 4) {
-            // START / STOP knop
-            if (dmxState == DMX_IDLE) {
-                startDmxSequence();
-            } else {
-                stopDmxSequence();
-            }
-            redrawRow(4);
-        } 
-        else {
-            mode = MODE_EDIT;
-            timerEditField = 0;
-            redrawRow(selectedIndex);
-        }
-    }
+  // --- Encoder draaien ---
+  int8_t step = readEncoderStep();
+  if (step != 0) handleStep(step);
 
-    else { // MODE_EDIT
-        if (selectedIndex == 1) {
-            if (timerEditField == 0) {
-                clearTimerEditBoxes();
-                timerEditField = 1;
-                drawTimerEditBox();
-            } else {
-                mode = MODE_SELECT;
-                redrawRow(selectedIndex);
-            }
-        } else {
-            mode = MODE_SELECT;
-            redrawRow(selectedIndex);
-        }
-    }
+  // --- Knop gedrukt ---
+  if (buttonClicked()) handleClick();
 
-  }
   if (!displaySleeping && (millis() - lastActivityMs > sleepTimeout)) {
     display.enableDisplay(false);
     displaySleeping = true;
   }
 
+  // --- MIDI sync ---
+  midiSyncPoll();
+  midiClockOut();
+
   // --- DMX non-blocking loops ---
   dmxWriteFrame();
   dmxController();
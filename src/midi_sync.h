@@ -0,0 +1,423 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+// ===========================================================
+// MIDI SYNC: MIDI clock / MTC -> show-tijd
+// ===========================================================
+//
+// Pure logica, geen Arduino-afhankelijkheden (host test: tools/midi_sync_check.cpp).
+//
+// MidiUart decodeert bytes uit flank-tijdstempels (Timer1 input capture op
+// de Uno). Zo is de tijdstempel van elke byte het tijdstip van zijn startbit,
+// niet het moment waarop loop() hem verwerkt.
+//
+// MidiSync::feed() krijgt elke byte met die tijdstempel (micros). Ticks zijn
+// MIDI clocks (0xF8, 24 per kwartnoot) of MTC quarter-frames (0xF1). Een
+// alpha-beta filter (2e orde PLL) schat tijdstip en periode van de ticks.
+//
+// showMs() = positie van de master: ticks * nominale tickduur, plus
+// interpolatie tussen ticks. Voor MIDI clock is de nominale tickduur die
+// van MIDI_SYNC_BPM, een master die sneller speelt laat de timer dus
+// sneller lopen. MTC geeft een absolute positie (hh:mm:ss:ff).
+
+#define MIDI_SYNC_BPM        120   // referentietempo voor MIDI clock
+#define MIDI_SYNC_LOCK_TICKS 24    // goede ticks op rij voor lock
+#define MIDI_SYNC_OUTLIERS   4     // ticks op rij naast het rooster -> lock kwijt
+#define MIDI_SYNC_TIMEOUT_US 500000UL
+
+// ===========================================================
+// MIDI UART: bytes uit flanken
+// ===========================================================
+//
+// edge() krijgt het lijnniveau na elke flank (1 = mark/idle) en het tijdstip
+// (us). Elke bit wordt in het midden gesampled: het niveau van de laatste
+// flank daarvoor. 'lost' = de capture miste de flank daarna (de ISR zag de
+// lijn al terug gewisseld): die byte valt weg. Daarna (hold) telt een dalende
+// flank pas als startbit na het einde van dat frame, als de gemiste flank er
+// zeker in lag, of anders na >= 8.5 bits hoog: binnen een frame is de lijn
+// hoogstens 7 bits aan een stuk hoog voor een dalende flank, een startbit
+// volgt op stopbit + idle. Zo wordt een databit nooit een startbit.
+// Dat steunt op een ISR-latency onder 2 bits (64 us): flanken van dezelfde
+// richting liggen minstens zo ver uit elkaar, dus de ISR mist er nooit twee
+// ongemerkt. Boven 1 bit (32 us) latency vallen wel bytes weg. Gemeten met
+// de sweep in tools/midi_sync_check.cpp.
+
+#define MIDI_BIT_US     32       // 31250 baud
+#define MIDI_SETTLE_US  100      // poll(): flanken tot zo lang geleden kunnen nog onderweg zijn
+
+struct MidiUart {
+  bool     line;       // huidig niveau
+  bool     busy;       // byte bezig
+  bool     bad;        // flank gemist of framing fout
+  bool     hold;       // na resync: startbit enkel na holdUs of lange mark
+  bool     holdTimed;  // holdUs geldig
+  uint8_t  bit;        // volgende te samplen bit: 0 = start, 1..8 data, 9 stop
+  uint8_t  data;
+  uint32_t startUs;    // startbit van de lopende byte
+  uint32_t byteUs;     // startbit van de laatst afgewerkte byte
+  uint32_t riseUs;     // laatste stijgende flank (bij twijfel: zo laat mogelijk)
+  uint32_t holdUs;     // einde van het frame met de gemiste flank
+  uint16_t dropped;    // bytes verworpen (ter info)
+
+  void reset() {
+    line = true;
+    busy = false;
+    bad = false;
+    hold = false;
+    holdTimed = false;
+    bit = 0;
+    data = 0;
+    startUs = 0;
+    byteUs = 0;
+    riseUs = 0;
+    holdUs = 0;
+    dropped = 0;
+  }
+
+  // Flank(en) gemist: lopende byte weg, verder vanaf het huidige niveau.
+  // 'latestRiseUs' = laatst mogelijke tijdstip van een gemiste stijgende flank.
+  void resync(bool levelNow, uint32_t latestRiseUs) {
+    if (busy) dropped++;
+    busy = false;
+    line = levelNow;
+    hold = true;
+    holdTimed = false;
+    riseUs = latestRiseUs;
+  }
+
+  // Bits samplen waarvan het midden voor 't' ligt
+  void sampleUntil(uint32_t t) {
+    while (bit <= 9 && (uint32_t)(t - startUs) > (uint32_t)bit * MIDI_BIT_US + MIDI_BIT_US / 2) {
+      if (bit == 0)      bad |= line;     // startbit moet 0 zijn
+      else if (bit == 9) bad |= !line;    // stopbit moet 1 zijn
+      else if (line)     data |= 1 << (bit - 1);
+      bit++;
+    }
+  }
+
+  // Lopende byte afwerken: byte of -1
+  int16_t finish() {
+    busy = false;
+    if (bad) {
+      dropped++;
+      return -1;
+    }
+    byteUs = startUs;
+    return data;
+  }
+
+  // Geeft een afgewerkte byte terug (of -1). Een flank kan hoogstens één
+  // byte afsluiten: de vorige, als dit de startbit van de volgende is.
+  int16_t edge(bool level, uint32_t t, bool lost, bool levelNow) {
+    int16_t out = -1;
+
+    if (busy) {
+      sampleUntil(t);
+      if (bit > 9) out = finish();
+    }
+
+    if (!busy && !level && hold &&
+        ((holdTimed && (int32_t)(t - holdUs) >= 0) ||
+         (int32_t)(t - riseUs) >= (int32_t)(8 * MIDI_BIT_US + MIDI_BIT_US / 2))) {
+      hold = false;
+    }
+
+    if (!busy && !level && !hold) {
+      busy = true;
+      bad = false;
+      bit = 0;
+      data = 0;
+      startUs = t;
+    }
+    line = level;
+    if (level) riseUs = t;
+
+    // De gemiste flank lag binnen de ISR-latency (< 2 bits) na 't'. Valt
+    // dat venster binnen de lopende byte, dan is de lijn vrij na zijn stopbit.
+    if (lost) {
+      bool inFrame = busy && (int32_t)(startUs + 8 * MIDI_BIT_US - t) >= 0;
+      uint32_t frameEnd = startUs + 10 * MIDI_BIT_US - MIDI_BIT_US / 2;
+      resync(levelNow, t + 2 * MIDI_BIT_US);
+      if (inFrame) {
+        holdTimed = true;
+        holdUs = frameEnd;
+      }
+    }
+    return out;
+  }
+
+  // Geen flank meer sinds de stopbit: byte afsluiten
+  int16_t poll(uint32_t nowUs) {
+    if (!busy) return -1;
+    if ((uint32_t)(nowUs - startUs) < 10 * MIDI_BIT_US + MIDI_SETTLE_US) return -1;
+    sampleUntil(startUs + 10 * MIDI_BIT_US);
+    return finish();
+  }
+};
+
+// ===========================================================
+// MIDI SYNC: parser + PLL
+// ===========================================================
+
+enum MidiSyncSource : uint8_t { SYNC_NONE, SYNC_MIDI_CLOCK, SYNC_MTC };
+
+struct MidiSync {
+  uint8_t  source;
+  bool     running;       // Start/Continue ontvangen (MTC: altijd)
+  bool     locked;
+  bool     startPending;  // eerste 0xF8 na Start = positie 0
+  bool     stopSuspect;   // 0xFC op de plaats van een clock, zie feed()
+  bool     gapPending;    // timeout terwijl de master liep, zie tick()
+  uint8_t  goodTicks;
+  uint8_t  outliers;      // ticks op rij naast het rooster (gelocked)
+
+  uint32_t ticks;         // positie in ticks
+  uint32_t usNum;         // nominale tickduur = usNum / usDen us
+  uint32_t usDen;
+  uint32_t estTickUs;     // geschat tijdstip van de laatste tick (lokaal)
+  uint32_t periodUs;      // geschatte tick-periode (lokaal)
+  uint32_t lastRxUs;
+  uint32_t stopUs;        // tijdstip van de verdachte 0xFC
+
+  uint8_t  status;        // lopend systeembericht (0xF1 / 0xF2)
+  uint8_t  data[2];
+  uint8_t  dataCount;
+  uint8_t  mtc[8];        // MTC nibbles per piece
+  uint8_t  mtcSeen;
+
+  void reset() {
+    source = SYNC_NONE;
+    running = false;
+    locked = false;
+    startPending = false;
+    stopSuspect = false;
+    gapPending = false;
+    goodTicks = 0;
+    outliers = 0;
+    ticks = 0;
+    usNum = 0;
+    usDen = 1;
+    estTickUs = 0;
+    periodUs = 0;
+    lastRxUs = 0;
+    stopUs = 0;
+    status = 0;
+    memset(data, 0, sizeof(data));
+    dataCount = 0;
+    memset(mtc, 0, sizeof(mtc));
+    mtcSeen = 0;
+  }
+
+  void setSource(uint8_t src, uint32_t num, uint32_t den) {
+    if (source == src && usNum == num && usDen == den) return;
+    source = src;
+    usNum = num;
+    usDen = den;
+    periodUs = num / den;
+    locked = false;
+    goodTicks = 0;
+    outliers = 0;
+  }
+
+  void feed(uint8_t b, uint32_t nowUs) {
+    lastRxUs = nowUs;
+
+    // Realtime berichten mogen overal tussen staan
+    if (b >= 0xF8) {
+      switch (b) {
+        case 0xF8:
+          setSource(SYNC_MIDI_CLOCK, 2500000UL, MIDI_SYNC_BPM);
+          if (stopSuspect) resolveStop(nowUs);
+          if (startPending) startPending = false;
+          else if (running) ticks++;
+          tick(nowUs);
+          break;
+        case 0xFA: running = true; startPending = true; stopSuspect = false; gapPending = false; ticks = 0; break;
+        case 0xFB: running = true; stopSuspect = false; gapPending = false; break;
+        case 0xFC:
+          // Valt de Stop precies op een verwachte clock, dan kan het een
+          // verminkte 0xF8 zijn: pas beslissen bij de volgende clock.
+          if (running && locked && onGrid(nowUs)) {
+            stopSuspect = true;
+            stopUs = nowUs;
+          } else {
+            running = false;
+            gapPending = false;
+          }
+          break;
+      }
+      return;
+    }
+
+    if (b & 0x80) {
+      status = b;
+      dataCount = 0;
+      return;
+    }
+
+    if (status != 0xF1 && status != 0xF2) return;
+    data[dataCount++] = b;
+
+    if (status == 0xF1) {
+      mtcQuarterFrame(data[0], nowUs);
+      dataCount = 0;
+    }
+    else if (dataCount == 2) {
+      // Song Position Pointer: 16e noten, 6 clocks per 16e
+      ticks = (((uint32_t)data[1] << 7) | data[0]) * 6;
+      startPending = false;
+      gapPending = false;
+      dataCount = 0;
+    }
+  }
+
+  void mtcQuarterFrame(uint8_t d, uint32_t nowUs) {
+    uint8_t piece = d >> 4;
+    mtc[piece] = d & 0x0F;
+    mtcSeen |= (1 << piece);
+
+    static const uint8_t MTC_FPS[4] = { 24, 25, 30, 30 };  // 29.97 DF ~ 30
+    uint8_t fps = MTC_FPS[(mtc[7] >> 1) & 0x03];
+    setSource(SYNC_MTC, 250000UL, fps);
+    running = true;
+    ticks++;
+
+    if (piece == 7 && mtcSeen == 0xFF) {
+      // Volledige tijdcode = positie bij piece 0, nu 7 quarter-frames later
+      uint32_t hh = mtc[6] | ((mtc[7] & 0x01) << 4);
+      uint32_t mm = mtc[4] | (mtc[5] << 4);
+      uint32_t ss = mtc[2] | (mtc[3] << 4);
+      uint32_t ff = mtc[0] | (mtc[1] << 4);
+      ticks = (((hh * 60 + mm) * 60 + ss) * fps + ff) * 4 + 7;
+      mtcSeen = 0;
+    }
+    tick(nowUs);
+  }
+
+  // Ligt 't' binnen de tolerantie van de volgende verwachte tick?
+  bool onGrid(uint32_t t) const {
+    int32_t err = (int32_t)(t - (estTickUs + periodUs));
+    int32_t tol = periodUs / 4;
+    return err > -tol && err < tol;
+  }
+
+  // Eerste clock na een verdachte Stop. Zelfde tick-slot: de master stopte
+  // echt (clock en Stop kort na elkaar). Eén slot later: de Stop stond op de
+  // plaats van een clock, dus die clock alsnog tellen.
+  void resolveStop(uint32_t t) {
+    stopSuspect = false;
+    if ((uint32_t)(t - stopUs) < periodUs / 2) {
+      running = false;
+    } else {
+      ticks++;
+      tick(stopUs);
+    }
+  }
+
+  // Alpha-beta filter op het tijdstip van elke tick
+  void tick(uint32_t t) {
+    if (goodTicks == 0) {
+      // Na een timeout (bv. loop() hing, capture-buffer liep over): de
+      // master speelde door. Gemiste ticks tellen op de laatste periode,
+      // anders loopt deze box voorgoed achter op de andere.
+      if (gapPending && running && periodUs > 0) {
+        uint32_t n = ((uint32_t)(t - estTickUs) + periodUs / 2) / periodUs;
+        if (n > 1) ticks += n - 1;   // deze tick is al geteld
+      }
+      gapPending = false;
+      estTickUs = t;
+      goodTicks = 1;
+      return;
+    }
+
+    uint32_t nominal = usNum / usDen;
+
+    if (!locked) {
+      // Acquire: periode volgt het gemeten interval, geen rooster
+      int32_t interval = (int32_t)(t - estTickUs);
+      int32_t err = interval - (int32_t)periodUs;
+      int32_t p = (int32_t)periodUs + err / 4;
+      if (p < (int32_t)(nominal / 2)) p = nominal / 2;
+      if (p > (int32_t)(nominal * 2)) p = nominal * 2;
+      periodUs = p;
+      estTickUs = t;
+
+      int32_t tol = periodUs / 8;
+      if (err > -tol && err < tol) {
+        if (++goodTicks >= MIDI_SYNC_LOCK_TICKS) {
+          locked = true;
+          outliers = 0;
+        }
+      } else {
+        goodTicks = 1;
+      }
+      return;
+    }
+
+    uint32_t pred = estTickUs + periodUs;
+    int32_t err = (int32_t)(t - pred);
+    int32_t tol = periodUs / 4;
+
+    // Gemiste ticks (verworpen byte): enkel als de vorige tick op het rooster
+    // lag en deze exact op een later punt ervan valt. Een tick die gewoon
+    // laat is of een tempo dat wegloopt, telt niet dubbel.
+    if (outliers == 0 && err > (int32_t)(periodUs / 2)) {
+      uint32_t missed = ((uint32_t)err + periodUs / 2) / periodUs;
+      int32_t rest = err - (int32_t)(missed * periodUs);
+      if (rest > -tol && rest < tol) {
+        if (running) ticks += missed;
+        pred += missed * periodUs;
+        err = rest;
+      }
+    }
+
+    if (err <= -tol || err >= tol) {
+      // Naast het rooster: telt als deze ene tick, filter niet bijsturen.
+      // Blijft het zo (tempowissel), dan opnieuw acquire.
+      estTickUs = pred;
+      if (++outliers >= MIDI_SYNC_OUTLIERS) {
+        locked = false;
+        goodTicks = 1;
+        estTickUs = t;
+      }
+      return;
+    }
+    outliers = 0;
+
+    estTickUs = pred + err / 4;
+    int32_t p = (int32_t)periodUs + err / 32;
+    if (p < (int32_t)(nominal / 2)) p = nominal / 2;
+    if (p > (int32_t)(nominal * 2)) p = nominal * 2;
+    periodUs = p;
+  }
+
+  // Geen bytes meer: lock kwijt, showMs() loopt verder op de laatste periode.
+  // MIDI clock stopt expliciet (0xFC), MTC stopt gewoon: daar = stilstand.
+  void poll(uint32_t nowUs) {
+    // Verdachte Stop zonder clock erna: de master stopte echt
+    if (stopSuspect && (uint32_t)(nowUs - stopUs) > 2 * periodUs) {
+      stopSuspect = false;
+      running = false;
+    }
+
+    if ((uint32_t)(nowUs - lastRxUs) <= MIDI_SYNC_TIMEOUT_US) return;
+    if (goodTicks > 0 && running && source == SYNC_MIDI_CLOCK) gapPending = true;
+    locked = false;
+    goodTicks = 0;
+    if (source == SYNC_MTC) running = false;
+  }
+
+  // Master loopt: show-tijd bruikbaar (ook tijdens acquire en freewheel)
+  bool active() const { return source != SYNC_NONE && running && periodUs > 0; }
+
+  uint32_t showMs(uint32_t nowUs) const {
+    uint32_t elapsed = running ? nowUs - estTickUs : 0;
+    if (locked && elapsed >= periodUs) elapsed = periodUs - 1;  // monotoon tot volgende tick
+
+    uint64_t us = (uint64_t)ticks * usNum / usDen
+                + (uint64_t)elapsed * usNum / ((uint64_t)usDen * periodUs);
+    return (uint32_t)(us / 1000);
+  }
+};
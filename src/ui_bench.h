@@ -0,0 +1,110 @@
+#pragma once
+
+#include <Adafruit_SSD1351.h>
+
+// ===========================================================
+// UI BENCH: mock SSD1351
+// ===========================================================
+//
+// Zelfde interface als Adafruit_SSD1351, maar er gaat niets naar het
+// scherm: elke teken-operatie wordt omgezet naar wat de echte driver over
+// SPI zou sturen. Per adresvenster 3 commando's + 4 databytes, per pixel
+// 2 bytes (RGB565). Clipping zoals Adafruit_SPITFT.
+//
+// Tekst: GFX tekent per gezette font-pixel een eigen venster (size 1) of
+// blokje van size x size. Het model rekent de volle 5x8 cel (bovengrens),
+// zodat de cijfers niet van glcdfont.c afhangen: de Uno en de host-build
+// (tools/ui_bench_host.cpp) tellen exact hetzelfde.
+
+#define BENCH_ADDR_WINDOW_BYTES 7
+#define BENCH_PIXEL_BYTES       2
+#define BENCH_GLYPH_PIXELS     40   // 5x8 cel
+
+struct BenchStats {
+  uint32_t spiBytes;
+  uint32_t pixels;
+  uint16_t windows;       // setAddrWindow() aanroepen
+  uint16_t transactions;  // startWrite() .. endWrite()
+  uint16_t glyphs;        // getekende tekens
+};
+
+class BenchSSD1351 : public Adafruit_SSD1351 {
+public:
+  using Adafruit_SSD1351::Adafruit_SSD1351;
+
+  BenchStats stats;
+
+  void resetStats() { memset(&stats, 0, sizeof(stats)); }
+
+  // Geen hardware: begin/rotatie sturen geen commando's
+  void begin(uint32_t = 0) override {}
+  void setRotation(uint8_t r) override { Adafruit_GFX::setRotation(r); }
+
+  void startWrite() override { trans(); }
+  void endWrite() override {}
+
+  void drawPixel(int16_t x, int16_t y, uint16_t) override {
+    trans();
+    area(x, y, 1, 1);
+  }
+  void writePixel(int16_t x, int16_t y, uint16_t) override { area(x, y, 1, 1); }
+
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t) override {
+    trans();
+    area(x, y, w, h);
+  }
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t) override {
+    area(x, y, w, h);
+  }
+
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t) override {
+    trans();
+    area(x, y, w, 1);
+  }
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t) override {
+    trans();
+    area(x, y, 1, h);
+  }
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t) override { area(x, y, w, 1); }
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t) override { area(x, y, 1, h); }
+
+  // Eén teken = één transactie met BENCH_GLYPH_PIXELS blokjes
+  size_t write(uint8_t c) override {
+    if (c != '\n' && c != '\r') {
+      uint32_t block = (uint32_t)textsize_x * textsize_y;
+      stats.glyphs++;
+      stats.transactions++;
+      stats.windows  += BENCH_GLYPH_PIXELS;
+      stats.pixels   += BENCH_GLYPH_PIXELS * block;
+      stats.spiBytes += BENCH_GLYPH_PIXELS * (BENCH_ADDR_WINDOW_BYTES + block * BENCH_PIXEL_BYTES);
+    }
+    // Cursor/wrap zoals GFX; de echte font-pixels tellen niet mee
+    inGlyph = true;
+    size_t n = Adafruit_SSD1351::write(c);
+    inGlyph = false;
+    return n;
+  }
+  using Adafruit_SSD1351::write;
+
+private:
+  bool inGlyph = false;
+
+  void trans() {
+    if (!inGlyph) stats.transactions++;
+  }
+
+  void area(int16_t x, int16_t y, int16_t w, int16_t h) {
+    if (inGlyph) return;
+    if (w < 0) { x += w + 1; w = -w; }
+    if (h < 0) { y += h + 1; h = -h; }
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > width())  w = width()  - x;
+    if (y + h > height()) h = height() - y;
+    if (w <= 0 || h <= 0) return;
+
+    stats.windows++;
+    stats.pixels   += (uint32_t)w * h;
+    stats.spiBytes += BENCH_ADDR_WINDOW_BYTES + (uint32_t)w * h * BENCH_PIXEL_BYTES;
+  }
+};
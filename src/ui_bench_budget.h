@@ -0,0 +1,23 @@
+#pragma once
+
+// ===========================================================
+// UI BENCH BUDGET
+// ===========================================================
+//
+// Toegelaten SPI-verkeer per scenario (volgorde = benchScenarios[] in
+// main.cpp). Tekst telt volgens het model in ui_bench.h, dus de cijfers zijn
+// op de Uno en op de host gelijk. Een UI-wijziging die meer tekent moet dit
+// bestand mee aanpassen, zodat de kost in de review zichtbaar is.
+// Nieuwe cijfers: make -C tools ui_bench && tools/ui_bench_host
+
+const BenchStats benchBudget[] PROGMEM = {
+  //   spiBytes  pixels  windows  trans  glyphs
+  {     88396,  30947,    3786,   471,     85 },   // boot
+  {    123360,  38384,    6656,   182,    166 },   // select-rows
+  {    157958,  48648,    8666,   317,    214 },   // spin-chan
+  {    115354,  25344,    9238,   334,    228 },   // spin-mm
+  {    116321,  25544,    9319,   337,    230 },   // spin-ss
+  {    153638,  48168,    8186,   305,    202 },   // spin-dur
+  {    180278,  51128,   11146,   379,    276 },   // spin-vol
+  {     20588,   5744,    1300,    40,     32 },   // timer-cycle
+};
@@ -0,0 +1,68 @@
+// ===========================================================
+// DMX TRACE GEN (host)
+// ===========================================================
+//
+// Maakt een synthetische pin-trace voor tools/dmx_trace_replay, in hetzelfde
+// CSV-formaat als een Saleae digital export. DmxSimple-achtig: elk frame
+// een break, MAB en start code + slots van 0x00 (36 us laag, rest van de
+// slot-periode hoog), vast aantal frames per seconde.
+//
+// Bouwen:  make -C tools dmx_trace_gen
+// Gebruik: tools/dmx_trace_gen BREAK_US MAB_US SLOT_US [SLOTS] [FPS] [SECONDEN] > trace.csv
+//          (defaults: 24 slots na de start code, 40 fps, 1.1 s)
+//
+// make -C tools check genereert de traces in tools/traces/ hiermee.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SLOT_LOW_US 36   // startbit + 8 databits van 0x00
+
+static void point(double us, int level) {
+  printf("%.9f,%d\n", us / 1e6, level);
+}
+
+int main(int argc, char** argv) {
+  if (argc < 4 || argc > 7) {
+    fprintf(stderr, "gebruik: %s BREAK_US MAB_US SLOT_US [SLOTS] [FPS] [SECONDEN]\n", argv[0]);
+    return 2;
+  }
+
+  double breakUs = atof(argv[1]);
+  double mabUs   = atof(argv[2]);
+  double slotUs  = atof(argv[3]);
+  int    slots   = argc > 4 ? atoi(argv[4]) : 24;
+  double fps     = argc > 5 ? atof(argv[5]) : 40;
+  double seconds = argc > 6 ? atof(argv[6]) : 1.1;
+
+  if (breakUs <= 0 || mabUs <= 0 || slotUs <= SLOT_LOW_US || slots < 1 || fps <= 0) {
+    fprintf(stderr, "ongeldige parameters (SLOT_US moet > %d zijn)\n", SLOT_LOW_US);
+    return 2;
+  }
+
+  double frameUs = 1e6 / fps;
+  double endUs   = seconds * 1e6;
+  if (breakUs + mabUs + (slots + 1) * slotUs > frameUs) {
+    fprintf(stderr, "frame past niet in 1/FPS\n");
+    return 2;
+  }
+
+  printf("Time [s],Channel 0\n");
+  point(0, 1);
+
+  // Eerste break na 100 us idle
+  for (double frame = 100; frame + frameUs <= endUs; frame += frameUs) {
+    double t = frame;
+    point(t, 0);
+    t += breakUs;
+    point(t, 1);
+    t += mabUs;
+    for (int s = 0; s <= slots; s++) {   // start code + slots
+      point(t, 0);
+      point(t + SLOT_LOW_US, 1);
+      t += slotUs;
+    }
+  }
+  point(endUs, 1);
+  return 0;
+}
@@ -0,0 +1,78 @@
+// ===========================================================
+// DMX TRACE REPLAY (host)
+// ===========================================================
+//
+// Voert een opgenomen pin-trace door dezelfde analyzer als de self-test
+// op de Uno (src/dmx_timing.h). Zo vang je timing-regressies zonder scope.
+//
+// Bouwen:  make -C tools          (of: g++ -std=c++11 -O2 -I src tools/dmx_trace_replay.cpp)
+// Gebruik: tools/dmx_trace_replay trace.csv
+// Check:   make -C tools check    (traces uit dmx_trace_gen, verwacht PASS/FAIL)
+//
+// Trace = CSV met per regel "tijd_in_seconden,niveau" (bv. Saleae digital
+// export). Regels die niet parsen (header) worden overgeslagen.
+// Exit code 0 = PASS, 1 = FAIL (timing buiten DMX512-A), 2 = leesfout.
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "dmx_timing.h"
+
+static void printHist(const char* name, const DmxTimingHist& h) {
+  printf("%-8s n=%-6u min=%-5u max=%-5u [", name, h.count, h.minUs, h.maxUs);
+  for (uint8_t i = 0; i < DMXT_BINS; i++) {
+    printf(i ? " %u" : "%u", h.bin[i]);
+  }
+  printf("]\n");
+}
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    fprintf(stderr, "gebruik: %s trace.csv\n", argv[0]);
+    return 2;
+  }
+
+  FILE* f = fopen(argv[1], "r");
+  if (!f) {
+    perror(argv[1]);
+    return 2;
+  }
+
+  DmxTiming timing;
+  timing.reset();
+
+  char line[128];
+  int level = -1;
+  uint64_t nextSecondTicks = 0;
+  bool first = true;
+
+  while (fgets(line, sizeof(line), f)) {
+    double tSec;
+    int lvl;
+    if (sscanf(line, "%lf,%d", &tSec, &lvl) != 2) continue;
+
+    uint64_t ticks = (uint64_t)(tSec * 2e6 + 0.5);  // 0.5 us ticks, zoals Timer1
+    if (first) {
+      nextSecondTicks = ticks + 2000000;
+      first = false;
+    }
+    while (ticks >= nextSecondTicks) {
+      timing.window(1000);
+      nextSecondTicks += 2000000;
+    }
+
+    lvl = lvl ? 1 : 0;
+    if (level >= 0 && lvl != level) timing.edge(lvl == 1, (uint16_t)ticks);
+    level = lvl;
+  }
+  fclose(f);
+
+  printHist("BRK us", timing.brk);
+  printHist("MAB us", timing.mab);
+  printHist("SLOT us", timing.slot);
+  printHist("FPS", timing.fps);
+
+  bool ok = timing.pass();
+  printf("%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
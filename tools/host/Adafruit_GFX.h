@@ -0,0 +1,95 @@
+#pragma once
+
+// ===========================================================
+// HOST MOCK: Adafruit_GFX
+// ===========================================================
+//
+// Zelfde virtuele interface als de bibliotheek. De generieke primitieven
+// (drawRect, fillScreen) roepen dezelfde virtuele functies aan als in
+// Adafruit_GFX.cpp, zodat BenchSSD1351 hier hetzelfde telt als op de Uno.
+// Tekst: BenchSSD1351 vervangt write(), de font is niet nodig.
+
+#include <Arduino.h>
+
+class Adafruit_GFX : public Print {
+public:
+  Adafruit_GFX(int16_t w, int16_t h)
+    : WIDTH(w), HEIGHT(h), _width(w), _height(h), rotation(0),
+      cursor_x(0), cursor_y(0), textcolor(0xFFFF), textbgcolor(0xFFFF),
+      textsize_x(1), textsize_y(1), wrap(true) {}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+  virtual void startWrite() {}
+  virtual void endWrite() {}
+  virtual void writePixel(int16_t x, int16_t y, uint16_t color) { drawPixel(x, y, color); }
+  virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    fillRect(x, y, w, h, color);
+  }
+  virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    drawFastVLine(x, y, h, color);
+  }
+  virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    drawFastHLine(x, y, w, color);
+  }
+
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    startWrite();
+    for (int16_t i = 0; i < h; i++) writePixel(x, y + i, color);
+    endWrite();
+  }
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    startWrite();
+    for (int16_t i = 0; i < w; i++) writePixel(x + i, y, color);
+    endWrite();
+  }
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    startWrite();
+    for (int16_t i = x; i < x + w; i++) writeFastVLine(i, y, h, color);
+    endWrite();
+  }
+  virtual void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    startWrite();
+    writeFastHLine(x, y, w, color);
+    writeFastHLine(x, y + h - 1, w, color);
+    writeFastVLine(x, y, h, color);
+    writeFastVLine(x + w - 1, y, h, color);
+    endWrite();
+  }
+
+  virtual void setRotation(uint8_t r) {
+    rotation = r & 3;
+    bool swap = rotation & 1;
+    _width  = swap ? HEIGHT : WIDTH;
+    _height = swap ? WIDTH  : HEIGHT;
+  }
+
+  void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+  void setTextSize(uint8_t s) { textsize_x = textsize_y = s ? s : 1; }
+  void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+  void setTextColor(uint16_t c, uint16_t bg) { textcolor = c; textbgcolor = bg; }
+  void setTextWrap(bool w) { wrap = w; }
+
+  // Enkel cursor: de echte glyph-pixels komen uit glcdfont.c
+  size_t write(uint8_t c) override {
+    if (c == '\n') { cursor_x = 0; cursor_y += textsize_y * 8; }
+    else if (c != '\r') cursor_x += textsize_x * 6;
+    return 1;
+  }
+  using Print::write;
+
+  int16_t width() const  { return _width; }
+  int16_t height() const { return _height; }
+  uint8_t getRotation() const { return rotation; }
+
+protected:
+  int16_t  WIDTH, HEIGHT;
+  int16_t  _width, _height;
+  uint8_t  rotation;
+  int16_t  cursor_x, cursor_y;
+  uint16_t textcolor, textbgcolor;
+  uint8_t  textsize_x, textsize_y;
+  bool     wrap;
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+// HOST MOCK: Adafruit_SPITFT + Adafruit_SSD1351 (zelfde virtuals, geen SPI)
+#include <Adafruit_GFX.h>
+#include <SPI.h>
+
+class Adafruit_SPITFT : public Adafruit_GFX {
+public:
+  Adafruit_SPITFT(uint16_t w, uint16_t h) : Adafruit_GFX(w, h) {}
+
+  virtual void begin(uint32_t freq) = 0;
+
+  void drawPixel(int16_t, int16_t, uint16_t) override {}
+  void writePixel(int16_t, int16_t, uint16_t) override {}
+  void fillRect(int16_t, int16_t, int16_t, int16_t, uint16_t) override {}
+  void writeFillRect(int16_t, int16_t, int16_t, int16_t, uint16_t) override {}
+  void drawFastHLine(int16_t, int16_t, int16_t, uint16_t) override {}
+  void drawFastVLine(int16_t, int16_t, int16_t, uint16_t) override {}
+  void writeFastHLine(int16_t, int16_t, int16_t, uint16_t) override {}
+  void writeFastVLine(int16_t, int16_t, int16_t, uint16_t) override {}
+};
+
+class Adafruit_SSD1351 : public Adafruit_SPITFT {
+public:
+  Adafruit_SSD1351(uint16_t w, uint16_t h, SPIClass*, int8_t, int8_t, int8_t)
+    : Adafruit_SPITFT(w, h) {}
+
+  void begin(uint32_t = 0) override {}
+  void setRotation(uint8_t r) override { Adafruit_GFX::setRotation(r); }
+  void enableDisplay(bool) {}
+};
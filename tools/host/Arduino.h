@@ -0,0 +1,112 @@
+#pragma once
+
+// ===========================================================
+// HOST MOCK: Arduino core
+// ===========================================================
+//
+// Net genoeg van de Arduino-API om src/main.cpp op de host te compileren
+// (tools/ui_bench_host.cpp). Registers zijn gewone variabelen, tijd loopt
+// 1 ms per millis()-aanroep, pinnen lezen HIGH (niets ingedrukt). UDR0 gaat
+// naar stdout. Geen Serial: main.cpp mag HardwareSerial niet linken.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <avr/pgmspace.h>
+
+#define HIGH 1
+#define LOW  0
+#define INPUT        0
+#define OUTPUT       1
+#define INPUT_PULLUP 2
+
+#define F_CPU 16000000UL
+#define DEC 10
+#define A0  14
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+extern unsigned long hostMillis;
+inline unsigned long millis()  { return hostMillis++; }
+inline unsigned long micros()  { return hostMillis * 1000UL; }
+inline void delay(unsigned long ms) { hostMillis += ms; }
+inline void delayMicroseconds(unsigned int) {}
+inline int  digitalRead(uint8_t) { return HIGH; }
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline void pinMode(uint8_t, uint8_t) {}
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+#define _BV(b) (1 << (b))
+#define ISR(v) void v()
+
+// Registers (enkel wat main.cpp aanraakt)
+extern volatile uint8_t  TCCR1A, TCCR1B, TIFR1, TIMSK1, PINB, PORTB;
+extern volatile uint8_t  UCSR0A, UCSR0B, UCSR0C;
+extern volatile uint16_t UBRR0;
+extern volatile uint8_t  ACSR, ADCSRA, ADCSRB, ADMUX, PORTD;
+extern volatile uint16_t ICR1, TCNT1;
+
+#define ICNC1  7
+#define ICES1  6
+#define CS11   1
+#define ICF1   5
+#define ICIE1  5
+#define PB0    0
+#define TXC0   6
+#define UDRE0  5
+#define U2X0   1
+#define TXCIE0 6
+#define UDRIE0 5
+#define TXEN0  3
+#define USBS0  3
+#define UCSZ01 2
+#define UCSZ00 1
+#define ACO    5
+#define ACBG   6
+#define ACIC   2
+#define ACME   6
+#define ADEN   7
+#define PD6    6
+
+// ---- Print: tekst en getallen naar write(uint8_t) ----
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n) {
+    for (size_t i = 0; i < n; i++) write(buf[i]);
+    return n;
+  }
+  size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+
+  size_t print(const char* s)                { return write(s); }
+  size_t print(const __FlashStringHelper* s) { return write(reinterpret_cast<const char*>(s)); }
+  size_t print(char c)                       { return write((uint8_t)c); }
+  size_t print(unsigned char v)              { return print((unsigned long)v); }
+  size_t print(int v)                        { return print((long)v); }
+  size_t print(unsigned int v)               { return print((unsigned long)v); }
+  size_t print(long v)          { char b[16]; snprintf(b, sizeof(b), "%ld", v); return write(b); }
+  size_t print(unsigned long v) { char b[16]; snprintf(b, sizeof(b), "%lu", v); return write(b); }
+
+  size_t println()                             { return write("\r\n"); }
+  template <typename T> size_t println(T v)    { size_t n = print(v); return n + println(); }
+};
+
+// ---- UDR0: naar stdout ----
+
+struct HostUdr {
+  HostUdr& operator=(uint8_t c) {
+    if (c != '\r') putchar(c);
+    return *this;
+  }
+};
+
+extern HostUdr UDR0;
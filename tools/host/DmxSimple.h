@@ -0,0 +1,13 @@
+#pragma once
+
+// HOST MOCK: DmxSimple (slots worden genegeerd)
+#include <Arduino.h>
+
+class DmxSimpleClass {
+public:
+  void usePin(uint8_t) {}
+  void maxChannel(int) {}
+  void write(int, uint8_t) {}
+};
+
+extern DmxSimpleClass DmxSimple;
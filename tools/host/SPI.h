@@ -0,0 +1,5 @@
+#pragma once
+
+// HOST MOCK: SPI (enkel het type, de bench stuurt niets)
+class SPIClass {};
+extern SPIClass SPI;
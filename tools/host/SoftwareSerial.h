@@ -0,0 +1,14 @@
+#pragma once
+
+// HOST MOCK: SoftwareSerial (ontvangt nooit iets)
+#include <Arduino.h>
+
+class SoftwareSerial : public Print {
+public:
+  SoftwareSerial(uint8_t, uint8_t) {}
+  void begin(long) {}
+  int available() { return 0; }
+  int read() { return -1; }
+  size_t write(uint8_t) override { return 1; }
+  using Print::write;
+};
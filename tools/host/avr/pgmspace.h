@@ -0,0 +1,8 @@
+#pragma once
+
+// HOST MOCK: PROGMEM = gewoon RAM
+#include <string.h>
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define memcpy_P memcpy
@@ -0,0 +1,386 @@
+// ===========================================================
+// MIDI SYNC CHECK (host)
+// ===========================================================
+//
+// Test voor src/midi_sync.h, zonder Uno.
+//
+// 1. MidiSync: tick-telling en lock bij late verwerking, verworpen bytes,
+//    stilstand voorbij de timeout, verdachte Stop en tempowissel.
+// 2. MidiUart + capture-model: een MIDI-stroom wordt omgezet in flanken en
+//    door een model van Timer1 input capture gestuurd, terwijl interrupts
+//    uit staan: continu in vensters van W us (worst case), en zoals
+//    DmxSimple doet (elke 2 ms 11 bytes van ~44 us met cli). Telt
+//    bytes ok / verworpen (gemeld) / fout (stil verkeerd gedecodeerd).
+//
+// Bouwen:  make -C tools midi_sync_check
+// Gebruik: tools/midi_sync_check   (exit code 0 = alle checks OK)
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+#include "midi_sync.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+  printf("%-58s %s\n", what, ok ? "ok" : "FOUT");
+  if (!ok) failures++;
+}
+
+// ---- 1. MidiSync ----
+
+static const uint32_t CLOCK_US = 2500000UL / MIDI_SYNC_BPM;   // 20833 us
+
+struct ClockRun {
+  MidiSync sync;
+  uint32_t t;        // tijdstip van de volgende clock (op het rooster)
+  uint32_t sent;     // 0xF8 na Start
+
+  void start() {
+    sync.reset();
+    t = 1000000;
+    sync.feed(0xFA, t - 1000);
+    sent = 0;
+  }
+
+  // Clock op het rooster, verwerkt met tijdstempel 'stamp'
+  void clockAt(uint32_t stamp) {
+    sync.feed(0xF8, stamp);
+    sync.poll(stamp);
+    sent++;
+    t += CLOCK_US;
+  }
+  void clock() { clockAt(t); }
+  void clocks(uint32_t n) { while (n--) clock(); }
+
+  // Na Start is de eerste clock positie 0
+  uint32_t expected() const { return sent ? sent - 1 : 0; }
+};
+
+static void testSync() {
+  ClockRun r;
+  char what[80];
+
+  r.start();
+  r.clocks(200);
+  check(r.sync.locked && r.sync.ticks == r.expected(), "200 clocks op tijd: gelocked, ticks = clocks");
+
+  // Eén clock 12 ms te laat verwerkt (oude poll-tijdstempel)
+  r.start();
+  r.clocks(150);
+  r.clockAt(r.t + 12000);
+  r.clocks(50);
+  snprintf(what, sizeof(what), "1 clock 12 ms laat: ticks %lu (verwacht %lu)",
+           (unsigned long)r.sync.ticks, (unsigned long)r.expected());
+  check(r.sync.ticks == r.expected() && r.sync.locked, what);
+
+  // 50 ms stilstand: de clocks die erin vielen komen samen binnen
+  r.start();
+  r.clocks(250);
+  uint32_t stallEnd = r.t - CLOCK_US + 50000;
+  while (r.t < stallEnd) r.clockAt(stallEnd);
+  r.clock();
+  r.clocks(20);
+  snprintf(what, sizeof(what), "50 ms stilstand, gebufferde clocks: ticks %lu (verwacht %lu)",
+           (unsigned long)r.sync.ticks, (unsigned long)r.expected());
+  check(r.sync.ticks == r.expected() && r.sync.locked, what);
+
+  // Stilstand langer dan de timeout: clocks gaan verloren (capture-buffer
+  // liep over), de master speelt door. Positie blijft die van de master.
+  static const uint32_t GAPS_MS[] = { 600, 2000 };
+  for (uint32_t gapMs : GAPS_MS) {
+    r.start();
+    r.clocks(200);
+    uint32_t gapEnd = r.t - CLOCK_US + gapMs * 1000UL;
+    while (r.t < gapEnd) {          // verstuurd, nooit ontvangen
+      r.t += CLOCK_US;
+      r.sent++;
+    }
+    r.sync.poll(gapEnd);            // eerste loop() na de stilstand: timeout
+    r.clocks(100);
+    snprintf(what, sizeof(what), "%lu ms zonder clocks (timeout): ticks %lu (verwacht %lu)",
+             (unsigned long)gapMs, (unsigned long)r.sync.ticks, (unsigned long)r.expected());
+    check(r.sync.ticks == r.expected() && r.sync.locked, what);
+  }
+
+  // Na een timeout: Start zet de positie op 0, de stilte telt niet mee
+  r.start();
+  r.clocks(100);
+  r.sync.poll(r.t + 1000000);
+  r.t += 1000000;
+  r.sync.feed(0xFA, r.t - 1000);
+  r.sent = 0;
+  r.clocks(50);
+  check(r.sync.ticks == r.expected(), "timeout, daarna Start: positie vanaf 0");
+
+  // Verworpen byte: clock ontbreekt, rooster vult hem aan
+  r.start();
+  r.clocks(100);
+  r.t += CLOCK_US;
+  r.sent++;
+  r.clocks(10);
+  check(r.sync.ticks == r.expected() && r.sync.locked, "verworpen clock: aangevuld via het rooster");
+
+  // Stop op de plaats van een clock, clocks lopen door: geen stop
+  r.start();
+  r.clocks(100);
+  r.sync.feed(0xFC, r.t);
+  r.t += CLOCK_US;
+  r.sent++;
+  r.clocks(10);
+  check(r.sync.running && r.sync.ticks == r.expected(), "0xFC op clock-slot, clocks lopen door: blijft lopen");
+
+  // Echte Stop: vlak na een clock
+  r.start();
+  r.clocks(100);
+  uint32_t pos = r.sync.ticks;
+  r.sync.feed(0xFC, r.t - CLOCK_US + 300);
+  r.clocks(5);
+  check(!r.sync.running && r.sync.ticks == pos, "0xFC vlak na clock: stop, positie bevroren");
+
+  // Echte Stop: net voor de clock van hetzelfde slot
+  r.start();
+  r.clocks(100);
+  pos = r.sync.ticks;
+  r.sync.feed(0xFC, r.t - 3000);
+  r.clocks(5);
+  check(!r.sync.running && r.sync.ticks == pos, "0xFC 3 ms voor clock: stop bij die clock");
+
+  // Echte Stop op het rooster, master stopt ook de clock
+  r.start();
+  r.clocks(100);
+  pos = r.sync.ticks;
+  r.sync.feed(0xFC, r.t);
+  r.sync.poll(r.t + 3 * CLOCK_US);
+  check(!r.sync.running && r.sync.ticks == pos, "0xFC zonder clocks erna: stop na 2 periodes");
+
+  // Tempowissel 120 -> 100 BPM: opnieuw lock, geen extra ticks
+  r.start();
+  r.clocks(100);
+  for (uint16_t i = 0; i < 100; i++) {
+    r.sync.feed(0xF8, r.t);
+    r.sync.poll(r.t);
+    r.sent++;
+    r.t += 25000;
+  }
+  check(r.sync.locked && r.sync.ticks == r.expected(), "tempowissel 120 -> 100 BPM: relock, ticks = clocks");
+}
+
+// ---- 2. MidiUart + capture-model ----
+
+struct Edge {
+  double t;
+  int    level;
+};
+
+struct Sent {
+  double  t;
+  uint8_t b;
+};
+
+static void sendByte(std::vector<Sent>& bytes, std::vector<Edge>& edges, double t, uint8_t b) {
+  bytes.push_back({ t, b });
+  uint16_t frame = ((uint16_t)b << 1) | 0x200;
+  int level = 1;
+  for (int bit = 0; bit < 10; bit++) {
+    int v = (frame >> bit) & 1;
+    if (v != level) edges.push_back({ t + bit * MIDI_BIT_US, v });
+    level = v;
+  }
+}
+
+// dense: willekeurige stroom van clocks, Stop/Start/Continue, MTC en notes,
+// met pauzes van 0 (back-to-back) tot 1 byte. Anders: wat een master stuurt,
+// clock aan 120 BPM plus MTC quarter-frames (24 fps), zo'n 10 s.
+static void makeStream(std::vector<Sent>& bytes, std::vector<Edge>& edges, uint32_t seed, bool dense) {
+  srand(seed);
+  double t = 100;
+  if (!dense) {
+    double clock = t, qf = t + (rand() % 10000);
+    while (clock < 10e6) {
+      if (clock <= qf) {
+        sendByte(bytes, edges, clock, 0xF8);
+        clock += CLOCK_US;
+      } else {
+        sendByte(bytes, edges, qf, 0xF1);
+        sendByte(bytes, edges, qf + 10 * MIDI_BIT_US, rand() & 0x7F);
+        qf += 1e6 / 96;
+      }
+      // Een byte onderweg schuift de volgende op
+      if (clock < bytes.back().t + 10 * MIDI_BIT_US) clock = bytes.back().t + 10 * MIDI_BIT_US;
+      if (qf < bytes.back().t + 10 * MIDI_BIT_US) qf = bytes.back().t + 10 * MIDI_BIT_US;
+    }
+    return;
+  }
+
+  for (int i = 0; i < 3000; i++) {
+    int kind = rand() % 8;
+    std::vector<uint8_t> msg;
+    if      (kind < 3)  msg.push_back(0xF8);
+    else if (kind == 3) msg.push_back(0xFC);
+    else if (kind == 4) msg.push_back((rand() & 1) ? 0xFA : 0xFB);
+    else if (kind == 5) { msg.push_back(0xF1); msg.push_back(rand() & 0x7F); }
+    else                { msg.push_back(0x90); msg.push_back(rand() & 0x7F); msg.push_back(rand() & 0x7F); }
+
+    for (uint8_t b : msg) {
+      sendByte(bytes, edges, t, b);
+      t += 10 * MIDI_BIT_US;
+    }
+    t += (rand() % 2) ? 0 : (rand() % 320);
+  }
+}
+
+struct SweepResult {
+  unsigned ok, dropped, wrong, clockAsStop, clockDropped;
+
+  void add(const SweepResult& r) {
+    ok += r.ok;
+    dropped += r.dropped;
+    wrong += r.wrong;
+    clockAsStop += r.clockAsStop;
+    clockDropped += r.clockDropped;
+  }
+};
+
+#define DMX_BURST_PERIOD_US 2040.0   // Timer2 ISR van DmxSimple
+#define DMX_BURST_BYTES     11
+#define DMX_BYTE_CLI_US     44.0     // 11 bits aan 4 us met cli
+#define DMX_BYTE_GAP_US     2.0      // sei tussen twee bytes
+
+// Interrupts uit op tijdstip t?  W > 0: continu vensters van W us met 1 us
+// ertussen.  W < 0: DmxSimple-model.
+static bool blockedAt(double t, double W) {
+  if (W > 0) return fmod(t, W + 1) < W;
+  if (W < 0) {
+    double inBurst = fmod(t, DMX_BURST_PERIOD_US);
+    double slot = DMX_BYTE_CLI_US + DMX_BYTE_GAP_US;
+    return inBurst < DMX_BURST_BYTES * slot && fmod(inBurst, slot) < DMX_BYTE_CLI_US;
+  }
+  return false;
+}
+
+static SweepResult sweep(double W, uint32_t seed, bool dense) {
+  std::vector<Sent> bytes;
+  std::vector<Edge> edges;
+  makeStream(bytes, edges, seed, dense);
+
+  MidiUart uart;
+  uart.reset();
+  std::vector<Sent> got;
+
+  const double STEP = 0.5;
+  double phase = (seed % 7) * 3.1 + seed * 211;
+  bool   capFall = true;     // ICES: volgende flank = lijn dalend
+  bool   icf = false;
+  double icr = 0;
+  int    line = 1;
+  size_t e = 0;
+  double end = bytes.back().t + 2000;
+  double nextPoll = 0;
+
+  for (double t = 0; t < end; t += STEP) {
+    while (e < edges.size() && edges[e].t <= t) {
+      line = edges[e].level;
+      if ((line == 0) == capFall) {   // hardware: flank in de gekozen richting
+        icf = true;
+        icr = edges[e].t;
+      }
+      e++;
+    }
+
+    if (icf && !blockedAt(t + phase, W)) {
+      // ISR: micros() heeft 4 us resolutie, ICR1 0.5 us
+      uint32_t micros = (uint32_t)(t / 4) * 4;
+      uint32_t stamp  = micros - (uint32_t)(t - icr);
+      int levelAfter  = capFall ? 0 : 1;
+      int16_t b = uart.edge(levelAfter, stamp, levelAfter != line, line);
+      if (b >= 0) got.push_back({ (double)uart.byteUs, (uint8_t)b });
+      capFall = (line == 1);
+      icf = false;
+    }
+
+    if (t >= nextPoll) {
+      int16_t b = uart.poll((uint32_t)t);
+      if (b >= 0) got.push_back({ (double)uart.byteUs, (uint8_t)b });
+      nextPoll = t + 50;
+    }
+  }
+
+  SweepResult r = { 0, 0, 0, 0, 0 };
+  std::vector<bool> seen(bytes.size(), false);
+  size_t j = 0;
+  unsigned matched = 0;
+  for (const Sent& g : got) {
+    while (j < bytes.size() && bytes[j].t < g.t - 8) j++;
+    if (j < bytes.size() && fabs(bytes[j].t - g.t) <= 8) {
+      matched++;
+      seen[j] = true;
+      if (bytes[j].b == g.b) r.ok++;
+      else {
+        r.wrong++;
+        if (bytes[j].b == 0xF8 && g.b == 0xFC) r.clockAsStop++;
+      }
+      j++;
+    } else {
+      r.wrong++;   // byte die niet verstuurd werd
+    }
+  }
+  r.dropped = bytes.size() - matched;
+  for (size_t i = 0; i < bytes.size(); i++) {
+    if (!seen[i] && bytes[i].b == 0xF8) r.clockDropped++;
+  }
+  return r;
+}
+
+static SweepResult sweepSeeds(double W, bool dense) {
+  SweepResult sum = { 0, 0, 0, 0, 0 };
+  for (uint32_t seed = 1; seed <= 3; seed++) sum.add(sweep(W, seed, dense));
+  return sum;
+}
+
+static void printRow(const char* label, const SweepResult& r) {
+  printf("%-9s %8u  %9u  %4u  %6u  %7u\n",
+         label, r.ok, r.dropped, r.wrong, r.clockAsStop, r.clockDropped);
+}
+
+static void testUart() {
+  static const double W[] = { 0, 20, 30, 44, 50, 60, 64, 70, 90, 130 };
+  char what[80];
+
+  printf("\nDichte stroom\n");
+  printf("W (us)    bytes ok  verworpen  fout  F8->FC  F8 weg\n");
+  for (double w : W) {
+    SweepResult sum = sweepSeeds(w, true);
+    snprintf(what, sizeof(what), "%.0f", w);
+    printRow(what, sum);
+
+    if (w == 0) {
+      check(sum.dropped == 0 && sum.wrong == 0, "W = 0: alle bytes correct");
+    }
+    if (w <= 60) {
+      snprintf(what, sizeof(what), "W = %.0f us: niets stil verkeerd, geen F8 -> FC", w);
+      check(sum.wrong == 0 && sum.clockAsStop == 0, what);
+    }
+  }
+  SweepResult dmx = sweepSeeds(-1, true);
+  printRow("DmxSimple", dmx);
+  check(dmx.wrong == 0 && dmx.clockAsStop == 0, "DmxSimple, dichte stroom: niets stil verkeerd");
+
+  printf("\nClock 120 BPM + MTC 24 fps\n");
+  printf("W (us)    bytes ok  verworpen  fout  F8->FC  F8 weg\n");
+  SweepResult real = sweepSeeds(-1, false);
+  printRow("DmxSimple", real);
+  snprintf(what, sizeof(what), "DmxSimple, clock + MTC: niets stil verkeerd, %.1f%% weg",
+           100.0 * real.dropped / (real.ok + real.dropped));
+  check(real.wrong == 0 && real.clockAsStop == 0, what);
+}
+
+int main() {
+  testSync();
+  testUart();
+  printf("%s\n", failures ? "FAIL" : "PASS");
+  return failures ? 1 : 0;
+}
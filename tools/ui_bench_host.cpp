@@ -0,0 +1,32 @@
+// ===========================================================
+// UI BENCH (host)
+// ===========================================================
+//
+// Compileert src/main.cpp met -DUI_BENCH tegen de mocks in tools/host/ en
+// draait dezelfde scenario's als env:uno_uibench op de Uno.
+//
+// Bouwen:  make -C tools ui_bench
+// Gebruik: tools/ui_bench_host     (exit code 0 = PASS, 1 = boven budget)
+
+#include "main.cpp"
+
+unsigned long hostMillis = 0;
+
+volatile uint8_t  TCCR1A, TCCR1B, TIFR1, TIMSK1, PINB, PORTB;
+volatile uint8_t  UCSR0A = _BV(UDRE0), UCSR0B, UCSR0C;   // zenden meteen klaar
+volatile uint16_t UBRR0;
+volatile uint8_t  ACSR, ADCSRA, ADCSRB, ADMUX, PORTD;
+volatile uint16_t ICR1, TCNT1;
+
+HostUdr        UDR0;
+SPIClass       SPI;
+DmxSimpleClass DmxSimple;
+
+int main() {
+  // Zelfde als setup() op de Uno
+  display.begin();
+  display.setRotation(0);
+  display.setTextWrap(false);
+
+  return uiBenchRun() ? 0 : 1;
+}